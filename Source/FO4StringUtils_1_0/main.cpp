@@ -7,12 +7,18 @@
 
 // F4SE
 #include "f4se/PluginAPI.h" // for plugin registration callback functions
+#include "f4se/PapyrusUtilities.h" // for CallFunctionNoWait_Internal
+#include "f4se/GameThreads.h" // for ITaskDelegate
 
 #include "main.h"           // for plugin name and version
 #include "functions.h"      // for plugin papyrus functions
+#include "async.h"          // for Async::SetEventSink
 
 IDebugLog gLog;
 
+F4SEPapyrusInterface* g_papyrus = nullptr;
+F4SETaskInterface* g_task = nullptr;
+
 const char* PluginVersion()
 {
 	return PLUGIN_VERSION_STRING; // from main.h
@@ -28,6 +34,65 @@ const char* RuntimeVersion()
 	return RUNTIME_VERSION_STRING; // from main.h
 }
 
+const char* LogFilePath()
+{
+	return PLUGIN_LOG_FILE_PATH; // from main.h
+}
+
+// Delivers a finished *Async job to scripts that called
+// RegisterForExternalEvent(ASYNC_EVENT_NAME, callback). Runs as a game
+// thread task, so the VM is never entered from a worker.
+class AsyncEventTask : public ITaskDelegate
+{
+public:
+	AsyncEventTask(SInt32 handle, SInt32 status, UInt32 session)
+		: m_handle(handle), m_status(status), m_session(session)
+	{
+	}
+
+	virtual void Run() override
+	{
+		// a load since the job finished took its handle with it
+		if (!Papyrus::Async::IsCurrentSession(m_session))
+		{
+			return;
+		}
+
+		VMArray<VMVariable> arguments;
+		VMVariable argument;
+
+		argument.Set(&m_handle);
+		arguments.Push(&argument);
+		argument.Set(&m_status);
+		arguments.Push(&argument);
+
+		g_papyrus->GetExternalEventRegistrations(ASYNC_EVENT_NAME, &arguments, [](UInt64 handle, const char* scriptName, const char* callbackName, void* data)
+		{
+			CallFunctionNoWait_Internal(handle, scriptName, callbackName, *static_cast<VMArray<VMVariable>*>(data));
+		});
+	}
+
+private:
+	SInt32 m_handle;
+	SInt32 m_status;
+	UInt32 m_session;
+};
+
+// Async event sink; runs on a worker thread and only queues the task
+void SendAsyncEvent(SInt32 handle, SInt32 status, UInt32 session)
+{
+	g_task->AddTask(new AsyncEventTask(handle, status, session));
+}
+
+// Handles from the last game mean nothing once another is loaded
+void OnF4SEMessage(F4SEMessagingInterface::Message* msg)
+{
+	if (msg->type == F4SEMessagingInterface::kMessage_PreLoadGame || msg->type == F4SEMessagingInterface::kMessage_NewGame)
+	{
+		Papyrus::CloseAllHandles();
+	}
+}
+
 // F4SE Plugin Query - Called when the plugin is queried
 extern "C" bool F4SEPlugin_Query(const F4SEInterface* f4se, PluginInfo* info)
 {
@@ -70,6 +135,22 @@ extern "C" bool F4SEPlugin_Load(const F4SEInterface* f4se)
 		return false;
 	}
 
+	// completion events from the *Async natives go out through papyrus external
+	// events, delivered on the game thread; without the task interface they are dropped
+	g_papyrus = papyrus;
+	g_task = (F4SETaskInterface*)f4se->QueryInterface(kInterface_Task);
+	if (g_task)
+	{
+		Papyrus::Async::SetEventSink(SendAsyncEvent);
+	}
+
+	// script handles are closed when a save is loaded or a new game starts
+	F4SEMessagingInterface* messaging = (F4SEMessagingInterface*)f4se->QueryInterface(kInterface_Messaging);
+	if (messaging)
+	{
+		messaging->RegisterListener(f4se->GetPluginHandle(), "F4SE", OnF4SEMessage);
+	}
+
 	// register papyrus functions
 	return papyrus->Register(Papyrus::RegisterFunctions);
 }
@@ -34,3 +34,4 @@
 // PapyrusInterfaces.cpp
 // PapyrusValue.cpp
 // PapyrusVM.cpp
+// PapyrusUtilities.cpp
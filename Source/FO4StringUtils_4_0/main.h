@@ -33,3 +33,4 @@
 // PapyrusInterfaces.cpp
 // PapyrusValue.cpp
 // PapyrusVM.cpp
+// PapyrusUtilities.cpp
@@ -0,0 +1,69 @@
+#pragma once
+
+// =====================================================
+// Stand-in for the F4SE common prefix header (Linux only)
+// =====================================================
+
+// Provides just enough of common/IPrefix.h and the Win32 API for the shared
+// plugin sources to build outside the game. Each shim behaves as the plugin
+// would with no INI file and no My Documents folder.
+
+#include <cstdarg>                          // for va_list
+#include <cstdint>                          // for fixed width integers
+#include <cstdio>                           // for vfprintf
+
+#include <pthread.h>                        // for pthread_self
+
+typedef int8_t   SInt8;
+typedef uint8_t  UInt8;
+typedef int16_t  SInt16;
+typedef uint16_t UInt16;
+typedef int32_t  SInt32;
+typedef uint32_t UInt32;
+typedef int64_t  SInt64;
+typedef uint64_t UInt64;
+
+typedef void*         HANDLE;
+typedef unsigned long DWORD;
+typedef long          HRESULT;
+
+#ifndef NULL
+#define NULL 0
+#endif
+
+#define MAX_PATH            260
+#define CSIDL_MYDOCUMENTS   0x0005
+#define SHGFP_TYPE_CURRENT  0
+#define E_FAIL              ((HRESULT)0x80004005L)
+#define SUCCEEDED(hr)       (((HRESULT)(hr)) >= 0)
+
+// Plugin log lines go to stderr
+//
+inline void _MESSAGE(const char* fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+// No INI outside the game: every setting takes its default
+//
+inline unsigned int GetPrivateProfileIntA(const char* section, const char* key, int defaultValue, const char* fileName)
+{
+    return static_cast<unsigned int>(defaultValue);
+}
+
+inline DWORD GetCurrentThreadId()
+{
+    return static_cast<DWORD>(reinterpret_cast<uintptr_t>(pthread_self()));
+}
+
+// No My Documents folder, so log-relative files (traces) are not written
+//
+inline HRESULT SHGetFolderPathA(void* hwnd, int folder, HANDLE token, DWORD flags, char* path)
+{
+    path[0] = '\0';
+    return E_FAIL;
+}
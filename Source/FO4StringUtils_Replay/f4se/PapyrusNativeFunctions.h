@@ -0,0 +1,238 @@
+#pragma once
+
+// ======================================================
+// Stand-in for the F4SE Papyrus native types (Linux only)
+// ======================================================
+
+// Mirrors the parts of BSFixedString, VMArray, NativeFunctionN and
+// VirtualMachine the shared sources use. Registered natives are kept by
+// name so the replay tool can invoke them with arguments read from a
+// capture file instead of from the Papyrus VM stack.
+
+#include <chrono>                           // for std::chrono::steady_clock
+#include <map>                              // for std::map
+#include <memory>                           // for std::unique_ptr
+#include <mutex>                            // for std::mutex
+#include <set>                              // for std::set
+#include <string>                           // for std::string
+#include <tuple>                            // for std::tuple
+#include <type_traits>                      // for std::decay
+#include <utility>                          // for std::index_sequence
+#include <vector>                           // for std::vector
+
+// Interned string storage standing in for the game's string cache. Entries
+// live for the life of the process, like most of the game's strings.
+//
+class StringCache
+{
+public:
+    struct Entry
+    {
+        std::string value;
+    };
+
+    static Entry* Intern(const char* str)
+    {
+        static std::mutex lock;
+        static std::set<std::string>* pool = new std::set<std::string>();
+
+        std::lock_guard<std::mutex> guard(lock);
+        auto it = pool->insert(str ? str : "").first;
+
+        // std::set nodes never move, so the element address is a stable handle
+        return reinterpret_cast<Entry*>(const_cast<std::string*>(&*it));
+    }
+};
+
+class BSFixedString
+{
+public:
+    BSFixedString() : data(nullptr) { }
+    BSFixedString(const char* str) : data(StringCache::Intern(str)) { }
+
+    const char* c_str() const
+    {
+        return data ? reinterpret_cast<const std::string*>(data)->c_str() : "";
+    }
+
+    // Interned strings compare by identity, as in the game
+    bool operator==(const BSFixedString& other) const { return data == other.data; }
+    bool operator!=(const BSFixedString& other) const { return data != other.data; }
+
+    StringCache::Entry* data;
+};
+
+template <typename T>
+class VMArray
+{
+public:
+    UInt32 Length() { return static_cast<UInt32>(m_data.size()); }
+
+    void Get(T* dst, const UInt32 idx) { *dst = m_data[idx]; }
+    void Set(T* src, const UInt32 idx) { m_data[idx] = *src; }
+    void Push(T* src) { m_data.push_back(*src); }
+
+    bool IsNone() { return m_none; }
+    void SetNone(bool none) { m_none = none; }
+
+private:
+    std::vector<T> m_data;
+    bool m_none = false;
+};
+
+// vector<bool> has no addressable elements, so keep bools as bytes
+template <>
+class VMArray<bool>
+{
+public:
+    UInt32 Length() { return static_cast<UInt32>(m_data.size()); }
+
+    void Get(bool* dst, const UInt32 idx) { *dst = m_data[idx] != 0; }
+    void Set(bool* src, const UInt32 idx) { m_data[idx] = *src ? 1 : 0; }
+    void Push(bool* src) { m_data.push_back(*src ? 1 : 0); }
+
+    bool IsNone() { return m_none; }
+    void SetNone(bool none) { m_none = none; }
+
+private:
+    std::vector<UInt8> m_data;
+    bool m_none = false;
+};
+
+struct StaticFunctionTag
+{
+};
+
+// Where a replayed call reads its arguments from, one per parameter in order.
+// Each Read returns false if the recorded argument has a different type.
+//
+class ArgSource
+{
+public:
+    virtual ~ArgSource() { }
+
+    virtual bool Read(SInt32& value) = 0;
+    virtual bool Read(bool& value) = 0;
+    virtual bool Read(float& value) = 0;
+    virtual bool Read(BSFixedString& value) = 0;
+    virtual bool Read(VMArray<SInt32>& value) = 0;
+    virtual bool Read(VMArray<bool>& value) = 0;
+    virtual bool Read(VMArray<float>& value) = 0;
+    virtual bool Read(VMArray<BSFixedString>& value) = 0;
+};
+
+class IFunction
+{
+public:
+    enum
+    {
+        kFunctionFlag_NoWait = 1 << 0,
+    };
+
+    virtual ~IFunction() { }
+
+    virtual const char* GetName() const = 0;
+    virtual UInt32 GetParamCount() const = 0;
+
+    // Decode the arguments, then time only the native itself.
+    // Returns false if the arguments do not match the signature.
+    //
+    virtual bool Replay(ArgSource& source, UInt64& nanoseconds) = 0;
+};
+
+class VirtualMachine
+{
+public:
+    void RegisterFunction(IFunction* fn)
+    {
+        m_functions[fn->GetName()].reset(fn);
+    }
+
+    void SetFunctionFlags(const char* className, const char* name, UInt32 flags)
+    {
+    }
+
+    IFunction* GetFunction(const std::string& name)
+    {
+        auto it = m_functions.find(name);
+        return it != m_functions.end() ? it->second.get() : nullptr;
+    }
+
+private:
+    std::map<std::string, std::unique_ptr<IFunction>> m_functions;
+};
+
+template <typename Base, typename Result, typename... Params>
+class NativeFunctionT : public IFunction
+{
+public:
+    typedef Result (*CallbackType)(Base*, Params...);
+
+    NativeFunctionT(const char* name, const char* className, CallbackType callback, VirtualMachine* vm)
+        : m_name(name), m_callback(callback)
+    {
+    }
+
+    const char* GetName() const override { return m_name.c_str(); }
+    UInt32 GetParamCount() const override { return sizeof...(Params); }
+
+    bool Replay(ArgSource& source, UInt64& nanoseconds) override
+    {
+        return Replay(source, nanoseconds, std::index_sequence_for<Params...>());
+    }
+
+private:
+    // Result is kept alive until after the clock stops so its destructor is not timed
+    template <typename R, typename... A>
+    struct Invoke
+    {
+        static R Call(CallbackType fn, A&... args) { return fn(nullptr, args...); }
+    };
+
+    template <typename... A>
+    struct Invoke<void, A...>
+    {
+        static int Call(CallbackType fn, A&... args) { fn(nullptr, args...); return 0; }
+    };
+
+    template <size_t... I>
+    bool Replay(ArgSource& source, UInt64& nanoseconds, std::index_sequence<I...>)
+    {
+        std::tuple<typename std::decay<Params>::type...> args;
+
+        bool ok = true;
+        int unused[] = { 0, (ok = ok && source.Read(std::get<I>(args)), 0)... };
+        (void)unused;
+
+        if (!ok)
+        {
+            return false;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto result = Invoke<Result, typename std::decay<Params>::type...>::Call(m_callback, std::get<I>(args)...);
+        const auto stop = std::chrono::steady_clock::now();
+        (void)result;
+
+        nanoseconds = static_cast<UInt64>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+        return true;
+    }
+
+    std::string m_name;
+    CallbackType m_callback;
+};
+
+template <typename B, typename R>
+using NativeFunction0 = NativeFunctionT<B, R>;
+template <typename B, typename R, typename P1>
+using NativeFunction1 = NativeFunctionT<B, R, P1>;
+template <typename B, typename R, typename P1, typename P2>
+using NativeFunction2 = NativeFunctionT<B, R, P1, P2>;
+template <typename B, typename R, typename P1, typename P2, typename P3>
+using NativeFunction3 = NativeFunctionT<B, R, P1, P2, P3>;
+template <typename B, typename R, typename P1, typename P2, typename P3, typename P4>
+using NativeFunction4 = NativeFunctionT<B, R, P1, P2, P3, P4>;
+template <typename B, typename R, typename P1, typename P2, typename P3, typename P4, typename P5>
+using NativeFunction5 = NativeFunctionT<B, R, P1, P2, P3, P4, P5>;
+template <typename B, typename R, typename P1, typename P2, typename P3, typename P4, typename P5, typename P6>
+using NativeFunction6 = NativeFunctionT<B, R, P1, P2, P3, P4, P5, P6>;
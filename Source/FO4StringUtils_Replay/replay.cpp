@@ -0,0 +1,462 @@
+// ==========================
+// Native Call Capture Replay
+// ==========================
+
+// Replays a capture file written with [Capture] bEnabled=1 against the shared
+// plugin sources built for Linux, then prints per-native latency and
+// throughput. Lets a hot path be profiled and compared across builds without
+// launching the game.
+//
+// Usage: FO4StringUtils_Replay [-n repeat] <FO4StringUtils.capture.bin>
+
+#include <algorithm>                        // for std::sort
+#include <atomic>                           // for std::atomic
+#include <cstdio>                           // for printf, fopen
+#include <cstdlib>                          // for atoi
+#include <cstring>                          // for memcpy, strcmp
+#include <map>                              // for std::map
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+#include "async.h"                          // for Async::SetEventSink
+#include "capture.h"                        // for Capture file layout
+#include "functions.h"                      // for Papyrus::RegisterFunctions
+#include "version.h"                        // for PluginVersion
+
+const char* PluginVersion()
+{
+    return "replay";
+}
+
+const char* GameVersion()
+{
+    return "none";
+}
+
+const char* RuntimeVersion()
+{
+    return "none";
+}
+
+const char* LogFilePath()
+{
+    return "FO4StringUtils_Replay.log";
+}
+
+namespace
+{
+    using namespace Papyrus;
+
+    // Stand-in for the F4SE external event: completions are counted by
+    // status instead of being sent to scripts
+    std::atomic<UInt64> g_asyncEvents[Async::kJob_TimedOut + 1];
+
+    void CountAsyncEvent(SInt32 handle, SInt32 status, UInt32 session)
+    {
+        g_asyncEvents[status]++;
+    }
+
+    // Reads tagged arguments out of one kRecord_Call payload
+    //
+    class PayloadReader : public ArgSource
+    {
+    public:
+        PayloadReader(const char* data, size_t size) : m_pos(data), m_end(data + size) { }
+
+        bool ReadCount(UInt8& count)
+        {
+            return ReadRaw(&count, sizeof(count));
+        }
+
+        bool Read(SInt32& value) override
+        {
+            return ReadTag(Capture::kArg_Int) && ReadRaw(&value, sizeof(value));
+        }
+
+        bool Read(bool& value) override
+        {
+            return ReadTag(Capture::kArg_Bool) && ReadBool(value);
+        }
+
+        bool Read(float& value) override
+        {
+            return ReadTag(Capture::kArg_Float) && ReadRaw(&value, sizeof(value));
+        }
+
+        bool Read(BSFixedString& value) override
+        {
+            return ReadTag(Capture::kArg_String) && ReadString(value);
+        }
+
+        bool Read(VMArray<SInt32>& value) override
+        {
+            return ReadTag(Capture::kArg_IntArray) && ReadArray(value, [this](SInt32& e) { return ReadRaw(&e, sizeof(e)); });
+        }
+
+        bool Read(VMArray<bool>& value) override
+        {
+            return ReadTag(Capture::kArg_BoolArray) && ReadArray(value, [this](bool& e) { return ReadBool(e); });
+        }
+
+        bool Read(VMArray<float>& value) override
+        {
+            return ReadTag(Capture::kArg_FloatArray) && ReadArray(value, [this](float& e) { return ReadRaw(&e, sizeof(e)); });
+        }
+
+        bool Read(VMArray<BSFixedString>& value) override
+        {
+            return ReadTag(Capture::kArg_StringArray) && ReadArray(value, [this](BSFixedString& e) { return ReadString(e); });
+        }
+
+    private:
+        bool ReadRaw(void* dst, size_t size)
+        {
+            if (static_cast<size_t>(m_end - m_pos) < size)
+            {
+                return false;
+            }
+
+            memcpy(dst, m_pos, size);
+            m_pos += size;
+            return true;
+        }
+
+        bool ReadTag(Capture::ArgType expected)
+        {
+            UInt8 tag = 0;
+            return ReadRaw(&tag, sizeof(tag)) && tag == expected;
+        }
+
+        bool ReadVarint(UInt64& value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 64 && m_pos < m_end; shift += 7)
+            {
+                const UInt8 byte = static_cast<UInt8>(*m_pos++);
+                value |= static_cast<UInt64>(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool ReadBool(bool& value)
+        {
+            UInt8 byte = 0;
+            if (!ReadRaw(&byte, sizeof(byte)))
+            {
+                return false;
+            }
+            value = byte != 0;
+            return true;
+        }
+
+        bool ReadString(BSFixedString& value)
+        {
+            UInt64 len = 0;
+            if (!ReadVarint(len) || static_cast<UInt64>(m_end - m_pos) < len)
+            {
+                return false;
+            }
+
+            value = BSFixedString(std::string(m_pos, static_cast<size_t>(len)).c_str());
+            m_pos += len;
+            return true;
+        }
+
+        template <typename T, typename ReadElement>
+        bool ReadArray(VMArray<T>& value, ReadElement readElement)
+        {
+            UInt64 count = 0;
+            if (!ReadVarint(count))
+            {
+                return false;
+            }
+
+            for (UInt64 i = 0; i < count; i++)
+            {
+                T element = T();
+                if (!readElement(element))
+                {
+                    return false;
+                }
+                value.Push(&element);
+            }
+            return true;
+        }
+
+        const char* m_pos;
+        const char* m_end;
+    };
+
+    struct Call
+    {
+        IFunction* function;
+        UInt32 id;
+        const char* payload;
+        size_t payloadLen;
+    };
+
+    struct FunctionResult
+    {
+        std::string name;
+        std::vector<UInt64> nanoseconds;
+        UInt64 payloadBytes = 0;
+        UInt64 failed = 0;
+    };
+
+    bool ReadFile(const char* path, std::string& contents)
+    {
+        FILE* file = fopen(path, "rb");
+        if (!file)
+        {
+            return false;
+        }
+
+        char buffer[64 * 1024];
+        size_t read = 0;
+        while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        {
+            contents.append(buffer, read);
+        }
+
+        const bool ok = ferror(file) == 0;
+        fclose(file);
+        return ok;
+    }
+
+    bool ReadVarint(const char*& pos, const char* end, UInt64& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < end; shift += 7)
+        {
+            const UInt8 byte = static_cast<UInt8>(*pos++);
+            value |= static_cast<UInt64>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Split the file into calls, resolving each id to the registered native.
+    // Calls to natives this build does not have are counted and skipped.
+    //
+    bool ParseCapture(const std::string& contents, VirtualMachine& vm, std::vector<Call>& calls, std::map<UInt32, FunctionResult>& results, UInt64& unknownCalls)
+    {
+        UInt32 header[2] = {};
+        if (contents.size() < sizeof(header))
+        {
+            fprintf(stderr, "capture file is truncated\n");
+            return false;
+        }
+
+        memcpy(header, contents.data(), sizeof(header));
+        if (header[0] != Capture::FILE_MAGIC || header[1] != Capture::FILE_VERSION)
+        {
+            fprintf(stderr, "not a version %u capture file\n", Capture::FILE_VERSION);
+            return false;
+        }
+
+        std::map<UInt32, IFunction*> functions;
+
+        const char* pos = contents.data() + sizeof(header);
+        const char* end = contents.data() + contents.size();
+
+        while (pos < end)
+        {
+            const UInt8 type = static_cast<UInt8>(*pos++);
+
+            UInt64 id = 0;
+            UInt64 len = 0;
+
+            // A capture cut short by a crash ends in a partial record; keep what came before it
+            if (!ReadVarint(pos, end, id) || !ReadVarint(pos, end, len) || static_cast<UInt64>(end - pos) < len)
+            {
+                fprintf(stderr, "ignoring truncated record at end of capture\n");
+                break;
+            }
+
+            const UInt32 functionId = static_cast<UInt32>(id);
+
+            if (type == Capture::kRecord_Function)
+            {
+                const std::string name(pos, static_cast<size_t>(len));
+                functions[functionId] = vm.GetFunction(name);
+                results[functionId].name = name;
+            }
+            else if (type == Capture::kRecord_Call)
+            {
+                auto it = functions.find(functionId);
+                if (it != functions.end() && it->second)
+                {
+                    calls.push_back({ it->second, functionId, pos, static_cast<size_t>(len) });
+                }
+                else
+                {
+                    unknownCalls++;
+                }
+            }
+
+            pos += len;
+        }
+
+        return true;
+    }
+
+    UInt64 Percentile(const std::vector<UInt64>& sorted, double fraction)
+    {
+        const size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+        return sorted[index];
+    }
+
+    void PrintReport(std::map<UInt32, FunctionResult>& results)
+    {
+        struct Row
+        {
+            FunctionResult* result;
+            UInt64 total;
+        };
+
+        std::vector<Row> rows;
+        for (auto& entry : results)
+        {
+            FunctionResult& result = entry.second;
+            if (result.nanoseconds.empty())
+            {
+                continue;
+            }
+
+            std::sort(result.nanoseconds.begin(), result.nanoseconds.end());
+
+            UInt64 total = 0;
+            for (UInt64 ns : result.nanoseconds)
+            {
+                total += ns;
+            }
+            rows.push_back({ &result, total });
+        }
+
+        // Most expensive natives first
+        std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b)
+        {
+            return a.total > b.total;
+        });
+
+        printf("%-28s %10s %12s %10s %10s %10s %12s %10s\n", "Function", "Calls", "Total ms", "Avg us", "p50 us", "p99 us", "Calls/s", "MB/s");
+
+        for (const Row& row : rows)
+        {
+            const FunctionResult& result = *row.result;
+            const double calls = static_cast<double>(result.nanoseconds.size());
+            const double seconds = row.total / 1e9;
+
+            printf("%-28s %10llu %12.3f %10.3f %10.3f %10.3f %12.0f %10.2f\n",
+                result.name.c_str(),
+                static_cast<unsigned long long>(result.nanoseconds.size()),
+                row.total / 1e6,
+                row.total / calls / 1e3,
+                Percentile(result.nanoseconds, 0.50) / 1e3,
+                Percentile(result.nanoseconds, 0.99) / 1e3,
+                seconds > 0 ? calls / seconds : 0.0,
+                seconds > 0 ? result.payloadBytes / seconds / (1024.0 * 1024.0) : 0.0);
+
+            if (result.failed)
+            {
+                printf("%-28s %10llu calls did not match the native's signature\n", "",
+                    static_cast<unsigned long long>(result.failed));
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int repeat = 1;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            repeat = atoi(argv[++i]);
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    if (!path || repeat < 1)
+    {
+        fprintf(stderr, "usage: %s [-n repeat] <capture file>\n", argv[0]);
+        return 2;
+    }
+
+    std::string contents;
+    if (!ReadFile(path, contents))
+    {
+        fprintf(stderr, "could not read %s\n", path);
+        return 1;
+    }
+
+    VirtualMachine vm;
+    Papyrus::RegisterFunctions(&vm);
+    Async::SetEventSink(CountAsyncEvent);
+
+    std::vector<Call> calls;
+    std::map<UInt32, FunctionResult> results;
+    UInt64 unknownCalls = 0;
+
+    if (!ParseCapture(contents, vm, calls, results, unknownCalls))
+    {
+        return 1;
+    }
+
+    // Replay in the captured order so handles come back with the same ids
+    for (int pass = 0; pass < repeat; pass++)
+    {
+        for (const Call& call : calls)
+        {
+            FunctionResult& result = results[call.id];
+
+            PayloadReader reader(call.payload, call.payloadLen);
+            UInt8 count = 0;
+            UInt64 nanoseconds = 0;
+
+            if (!reader.ReadCount(count) || count != call.function->GetParamCount() || !call.function->Replay(reader, nanoseconds))
+            {
+                result.failed++;
+                continue;
+            }
+
+            result.nanoseconds.push_back(nanoseconds);
+            result.payloadBytes += call.payloadLen;
+        }
+    }
+
+    printf("Replayed %llu calls x %d from %s\n\n", static_cast<unsigned long long>(calls.size()), repeat, path);
+    PrintReport(results);
+
+    // Jobs still queued at exit are not counted
+    const UInt64 asyncDone = g_asyncEvents[Async::kJob_Done];
+    const UInt64 asyncCancelled = g_asyncEvents[Async::kJob_Cancelled];
+    const UInt64 asyncTimedOut = g_asyncEvents[Async::kJob_TimedOut];
+    if (asyncDone + asyncCancelled + asyncTimedOut)
+    {
+        printf("\nAsync completion events: %llu done, %llu cancelled, %llu timed out\n",
+            static_cast<unsigned long long>(asyncDone),
+            static_cast<unsigned long long>(asyncCancelled),
+            static_cast<unsigned long long>(asyncTimedOut));
+    }
+
+    if (unknownCalls)
+    {
+        printf("\nSkipped %llu calls to natives this build does not register\n", static_cast<unsigned long long>(unknownCalls));
+    }
+
+    return 0;
+}
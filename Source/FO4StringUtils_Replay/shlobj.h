@@ -0,0 +1,3 @@
+#pragma once
+
+// Stand-in for the Windows shell header; SHGetFolderPathA is in common/IPrefix.h
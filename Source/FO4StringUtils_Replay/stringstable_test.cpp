@@ -0,0 +1,392 @@
+// =====================
+// String Table Fixtures
+// =====================
+
+// Writes a set of small .STRINGS, .DLSTRINGS and .ILSTRINGS tables, some of
+// them deliberately malformed, then checks that OpenDataStringsTable and the
+// StringsTable natives read or refuse each one as they should. Run by
+// "make test".
+//
+// Usage: FO4StringUtils_StringsTableTest [-w <dir>]
+//
+// With -w the fixtures are only written, under <dir>/Data/Strings, so they can
+// be copied into a game install and read from a script.
+
+#include <cstdio>                           // for printf, fopen
+#include <cstdlib>                          // for mkdtemp
+#include <cstring>                          // for memcpy, strcmp
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+#include <sys/stat.h>                       // for mkdir
+#include <unistd.h>                         // for chdir, rmdir
+
+#include "f4se/PapyrusNativeFunctions.h"    // for VMArray, BSFixedString
+#include "stringstable.h"                   // for OpenDataStringsTable
+#include "version.h"                        // for PluginVersion
+
+const char* PluginVersion()
+{
+    return "test";
+}
+
+const char* GameVersion()
+{
+    return "none";
+}
+
+const char* RuntimeVersion()
+{
+    return "none";
+}
+
+const char* LogFilePath()
+{
+    return "FO4StringUtils_StringsTableTest.log";
+}
+
+namespace Papyrus
+{
+    // Defined in functions.cpp, which has no header for the natives themselves
+    SInt32 StringsTableOpenFunction(StaticFunctionTag* base, BSFixedString pathBS);
+    BSFixedString StringsTableGetFunction(StaticFunctionTag* base, SInt32 handle, SInt32 id);
+    VMArray<BSFixedString> StringsTableGetManyFunction(StaticFunctionTag* base, SInt32 handle, VMArray<SInt32> ids);
+    bool StringsTableCloseFunction(StaticFunctionTag* base, SInt32 handle);
+}
+
+namespace
+{
+    using namespace Papyrus;
+
+    struct Entry
+    {
+        UInt32 id;
+        std::string value;
+    };
+
+    // Every well-formed fixture holds these, in this order in its directory
+    const std::vector<Entry> SORTED_ENTRIES =
+    {
+        { 1, "Vault-Tec" },
+        { 7, "" },
+        { 42, "Diamond City" },
+        { 0x0100, "Nuka-Cola Quantum" },
+        { 0xFFFFFFF0u, "High ID" },
+    };
+
+    const std::vector<Entry> UNSORTED_ENTRIES =
+    {
+        { 42, "Diamond City" },
+        { 0xFFFFFFF0u, "High ID" },
+        { 1, "Vault-Tec" },
+        { 0x0100, "Nuka-Cola Quantum" },
+        { 7, "" },
+    };
+
+    void AppendUInt32(std::string& out, UInt32 value)
+    {
+        char bytes[4];
+        memcpy(bytes, &value, sizeof(bytes));
+        out.append(bytes, sizeof(bytes));
+    }
+
+    void PatchUInt32(std::string& out, size_t position, UInt32 value)
+    {
+        memcpy(&out[position], &value, sizeof(value));
+    }
+
+    // Builds a table with the directory in the order given and the entries
+    // laid out one after another in the data block
+    //
+    std::string BuildTable(const std::vector<Entry>& entries, StringsTableFormat format)
+    {
+        std::string directory;
+        std::string data;
+
+        for (const Entry& entry : entries)
+        {
+            AppendUInt32(directory, entry.id);
+            AppendUInt32(directory, static_cast<UInt32>(data.length()));
+
+            if (format == kStringsTable_Prefixed)
+            {
+                AppendUInt32(data, static_cast<UInt32>(entry.value.length() + 1));
+            }
+            data.append(entry.value);
+            data.push_back('\0');
+        }
+
+        std::string table;
+        AppendUInt32(table, static_cast<UInt32>(entries.size()));
+        AppendUInt32(table, static_cast<UInt32>(data.length()));
+        return table + directory + data;
+    }
+
+    // Byte position of a directory entry's offset field
+    size_t DirectoryOffsetPosition(size_t index)
+    {
+        return 8 + index * 8 + 4;
+    }
+
+    struct Fixture
+    {
+        const char* name;
+        std::string bytes;
+    };
+
+    std::vector<Fixture> BuildFixtures()
+    {
+        std::vector<Fixture> fixtures;
+
+        fixtures.push_back({ "Sorted.STRINGS", BuildTable(SORTED_ENTRIES, kStringsTable_Terminated) });
+        fixtures.push_back({ "Unsorted.STRINGS", BuildTable(UNSORTED_ENTRIES, kStringsTable_Terminated) });
+        fixtures.push_back({ "Sorted.DLSTRINGS", BuildTable(SORTED_ENTRIES, kStringsTable_Prefixed) });
+        fixtures.push_back({ "Unsorted.ILSTRINGS", BuildTable(UNSORTED_ENTRIES, kStringsTable_Prefixed) });
+
+        // The header claims more data than the file holds
+        std::string truncated = BuildTable(SORTED_ENTRIES, kStringsTable_Terminated);
+        truncated.resize(truncated.length() - 4);
+        fixtures.push_back({ "Truncated.STRINGS", truncated });
+
+        // A count whose directory alone would run past the end of the file
+        std::string bigCount = BuildTable(SORTED_ENTRIES, kStringsTable_Prefixed);
+        PatchUInt32(bigCount, 0, 0x10000000u);
+        fixtures.push_back({ "BadCount.DLSTRINGS", bigCount });
+
+        fixtures.push_back({ "Short.STRINGS", std::string("\x01\x00\x00", 3) });
+
+        // ID 42 points past the data block; the rest stay readable
+        std::string offsetTable = BuildTable(SORTED_ENTRIES, kStringsTable_Terminated);
+        PatchUInt32(offsetTable, DirectoryOffsetPosition(2), 0x7FFFFFFFu);
+        fixtures.push_back({ "BadOffset.STRINGS", offsetTable });
+
+        std::string offsetPrefixed = BuildTable(UNSORTED_ENTRIES, kStringsTable_Prefixed);
+        PatchUInt32(offsetPrefixed, DirectoryOffsetPosition(0), 0x7FFFFFFFu);
+        fixtures.push_back({ "BadOffset.ILSTRINGS", offsetPrefixed });
+
+        // The last entry's length prefix runs past the data block
+        std::string longPrefix = BuildTable(SORTED_ENTRIES, kStringsTable_Prefixed);
+        PatchUInt32(longPrefix, longPrefix.length() - SORTED_ENTRIES.back().value.length() - 5, 0x1000u);
+        fixtures.push_back({ "BadLength.DLSTRINGS", longPrefix });
+
+        // The last entry has no terminator before the data block ends
+        std::string unterminated = BuildTable(SORTED_ENTRIES, kStringsTable_Terminated);
+        unterminated.pop_back();
+        PatchUInt32(unterminated, 4, static_cast<UInt32>(unterminated.length() - 8 - SORTED_ENTRIES.size() * 8));
+        fixtures.push_back({ "Unterminated.STRINGS", unterminated });
+
+        return fixtures;
+    }
+
+    bool WriteFile(const std::string& path, const std::string& bytes)
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file)
+        {
+            return false;
+        }
+
+        const bool written = fwrite(bytes.data(), 1, bytes.length(), file) == bytes.length();
+        return fclose(file) == 0 && written;
+    }
+
+    // Writes every fixture under root/Data/Strings, creating the folders as needed
+    //
+    bool WriteFixtures(const std::string& root, const std::vector<Fixture>& fixtures)
+    {
+        const std::string data = root + "/Data";
+        const std::string strings = data + "/Strings";
+        mkdir(root.c_str(), 0755);
+        mkdir(data.c_str(), 0755);
+        mkdir(strings.c_str(), 0755);
+
+        for (const Fixture& fixture : fixtures)
+        {
+            if (!WriteFile(strings + "/" + fixture.name, fixture.bytes))
+            {
+                fprintf(stderr, "Cannot write %s/%s\n", strings.c_str(), fixture.name);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void RemoveFixtures(const std::string& root, const std::vector<Fixture>& fixtures)
+    {
+        for (const Fixture& fixture : fixtures)
+        {
+            remove((root + "/Data/Strings/" + fixture.name).c_str());
+        }
+        rmdir((root + "/Data/Strings").c_str());
+        rmdir((root + "/Data").c_str());
+        rmdir(root.c_str());
+    }
+
+    int g_failures = 0;
+
+    void Check(bool passed, const std::string& what)
+    {
+        if (!passed)
+        {
+            printf("FAIL: %s\n", what.c_str());
+            g_failures++;
+        }
+    }
+
+    std::string Lookup(const StringsTable& table, UInt32 id, bool& found)
+    {
+        std::string value;
+        found = table.Get(id, value);
+        return value;
+    }
+
+    // Every ID in SORTED_ENTRIES resolves to its value, and IDs between and
+    // around them are missing
+    //
+    void CheckWellFormed(const char* name)
+    {
+        std::shared_ptr<StringsTable> table = OpenDataStringsTable(std::string("Strings\\") + name);
+        Check(table != nullptr, std::string(name) + " opens");
+        if (!table)
+        {
+            return;
+        }
+
+        Check(table->Count() == SORTED_ENTRIES.size(), std::string(name) + " count");
+
+        for (const Entry& entry : SORTED_ENTRIES)
+        {
+            bool found = false;
+            const std::string value = Lookup(*table, entry.id, found);
+            Check(found && value == entry.value, std::string(name) + " id " + std::to_string(entry.id));
+        }
+
+        for (UInt32 id : { 0u, 2u, 41u, 43u, 0xFFu, 0xFFFFFFFFu })
+        {
+            bool found = true;
+            Lookup(*table, id, found);
+            Check(!found, std::string(name) + " missing id " + std::to_string(id));
+        }
+    }
+
+    void CheckRefused(const char* path)
+    {
+        Check(OpenDataStringsTable(path) == nullptr, std::string(path) + " is refused");
+    }
+
+    // The table opens, but one ID's entry cannot be read
+    //
+    void CheckBadEntry(const char* name, UInt32 badId)
+    {
+        std::shared_ptr<StringsTable> table = OpenDataStringsTable(std::string("Strings\\") + name);
+        Check(table != nullptr, std::string(name) + " opens");
+        if (!table)
+        {
+            return;
+        }
+
+        for (const Entry& entry : SORTED_ENTRIES)
+        {
+            bool found = false;
+            const std::string value = Lookup(*table, entry.id, found);
+            if (entry.id == badId)
+            {
+                Check(!found, std::string(name) + " id " + std::to_string(entry.id) + " is unreadable");
+            }
+            else
+            {
+                Check(found && value == entry.value, std::string(name) + " id " + std::to_string(entry.id));
+            }
+        }
+    }
+
+    void CheckNatives()
+    {
+        const SInt32 handle = StringsTableOpenFunction(nullptr, BSFixedString("Strings\\Unsorted.ILSTRINGS"));
+        Check(handle != 0, "StringsTableOpen returns a handle");
+        Check(StringsTableOpenFunction(nullptr, BSFixedString("Strings\\Truncated.STRINGS")) == 0, "StringsTableOpen refuses a truncated table");
+        Check(StringsTableOpenFunction(nullptr, BSFixedString("Strings\\Missing.STRINGS")) == 0, "StringsTableOpen refuses a missing file");
+        Check(StringsTableOpenFunction(nullptr, BSFixedString("Strings\\Sorted.txt")) == 0, "StringsTableOpen refuses another extension");
+
+        Check(strcmp(StringsTableGetFunction(nullptr, handle, 42).c_str(), "Diamond City") == 0, "StringsTableGet finds an ID");
+        Check(strcmp(StringsTableGetFunction(nullptr, handle, -16).c_str(), "High ID") == 0, "StringsTableGet passes negative IDs as unsigned");
+        Check(strcmp(StringsTableGetFunction(nullptr, handle, 3).c_str(), "") == 0, "StringsTableGet returns \"\" for a missing ID");
+
+        // Missing IDs keep their slot, so results line up with the request
+        const SInt32 ids[] = { 0x0100, 3, 1, 7, -1, 42 };
+        const char* expected[] = { "Nuka-Cola Quantum", "", "Vault-Tec", "", "", "Diamond City" };
+
+        VMArray<SInt32> idArray;
+        for (SInt32 id : ids)
+        {
+            idArray.Push(&id);
+        }
+
+        VMArray<BSFixedString> values = StringsTableGetManyFunction(nullptr, handle, idArray);
+        Check(values.Length() == sizeof(ids) / sizeof(ids[0]), "StringsTableGetMany keeps one slot per ID");
+        for (UInt32 i = 0; i < values.Length() && i < sizeof(ids) / sizeof(ids[0]); i++)
+        {
+            BSFixedString value;
+            values.Get(&value, i);
+            Check(strcmp(value.c_str(), expected[i]) == 0, "StringsTableGetMany slot " + std::to_string(i));
+        }
+
+        Check(StringsTableCloseFunction(nullptr, handle), "StringsTableClose closes an open handle");
+        Check(!StringsTableCloseFunction(nullptr, handle), "StringsTableClose refuses a closed handle");
+        VMArray<BSFixedString> closedValues = StringsTableGetManyFunction(nullptr, handle, idArray);
+        Check(closedValues.Length() == 0, "StringsTableGetMany on a closed handle is empty");
+        Check(strcmp(StringsTableGetFunction(nullptr, handle, 42).c_str(), "") == 0, "StringsTableGet on a closed handle is \"\"");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::vector<Fixture> fixtures = BuildFixtures();
+
+    if (argc == 3 && strcmp(argv[1], "-w") == 0)
+    {
+        return WriteFixtures(argv[2], fixtures) ? 0 : 1;
+    }
+    if (argc != 1)
+    {
+        fprintf(stderr, "Usage: %s [-w <dir>]\n", argv[0]);
+        return 2;
+    }
+
+    char root[] = "/tmp/FO4StringUtils_Test.XXXXXX";
+    if (!mkdtemp(root) || !WriteFixtures(root, fixtures) || chdir(root) != 0)
+    {
+        fprintf(stderr, "Cannot set up fixtures under %s\n", root);
+        return 1;
+    }
+
+    CheckWellFormed("Sorted.STRINGS");
+    CheckWellFormed("Unsorted.STRINGS");
+    CheckWellFormed("Sorted.DLSTRINGS");
+    CheckWellFormed("Unsorted.ILSTRINGS");
+
+    CheckRefused("Strings\\Truncated.STRINGS");
+    CheckRefused("Strings\\BadCount.DLSTRINGS");
+    CheckRefused("Strings\\Short.STRINGS");
+    CheckRefused("Strings\\Missing.STRINGS");
+    CheckRefused("..\\Strings\\Sorted.STRINGS");
+
+    CheckBadEntry("BadOffset.STRINGS", 42);
+    CheckBadEntry("BadOffset.ILSTRINGS", 42);
+    CheckBadEntry("BadLength.DLSTRINGS", 0xFFFFFFF0u);
+    CheckBadEntry("Unterminated.STRINGS", 0xFFFFFFF0u);
+
+    CheckNatives();
+
+    RemoveFixtures(root, fixtures);
+
+    if (g_failures)
+    {
+        printf("%d check(s) failed\n", g_failures);
+        return 1;
+    }
+
+    printf("All string table checks passed\n");
+    return 0;
+}
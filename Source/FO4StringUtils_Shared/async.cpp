@@ -0,0 +1,161 @@
+// ===================
+// Background Natives
+// ===================
+
+#include <condition_variable>               // for std::condition_variable
+#include <deque>                            // for std::deque
+#include <mutex>                            // for std::mutex, std::call_once
+#include <thread>                           // for std::thread
+#include <utility>                          // for std::move
+
+#include "async.h"                          // for Async::Job
+#include "functions.h"                      // for PLUGIN_INI_FILE_PATH
+
+namespace Papyrus
+{
+    namespace Async
+    {
+        namespace
+        {
+            struct QueuedJob
+            {
+                SInt32 handle = 0;
+                UInt32 session = 0;         // g_session when submitted
+                std::shared_ptr<Job> job;
+            };
+
+            // Shared by the workers. Leaked on purpose: detached workers are
+            // still waiting on it when static destructors run at exit.
+            struct WorkQueue
+            {
+                std::mutex lock;
+                std::condition_variable ready;
+                std::deque<QueuedJob> jobs;
+            };
+
+            WorkQueue* g_queue = nullptr;
+            std::once_flag g_startOnce;
+            std::atomic<EventSink> g_eventSink(nullptr);
+            std::atomic<UInt32> g_session(0);
+
+            void WorkerLoop()
+            {
+                for (;;)
+                {
+                    QueuedJob next;
+                    {
+                        std::unique_lock<std::mutex> lock(g_queue->lock);
+                        g_queue->ready.wait(lock, [] { return !g_queue->jobs.empty(); });
+
+                        next = std::move(g_queue->jobs.front());
+                        g_queue->jobs.pop_front();
+                    }
+
+                    const SInt32 status = next.job->Run();
+
+                    // Drop the job before notifying so a closed handle frees its
+                    // result here rather than at the next job
+                    next.job.reset();
+
+                    // Scripts from before a load no longer know the handle
+                    if (!IsCurrentSession(next.session))
+                    {
+                        continue;
+                    }
+
+                    if (EventSink sink = g_eventSink.load())
+                    {
+                        sink(next.handle, status, next.session);
+                    }
+                }
+            }
+
+            // Workers live for the session like the VM threads they serve
+            void StartWorkers()
+            {
+                UInt32 count = GetPrivateProfileIntA("Async", "iWorkerThreads", DEFAULT_WORKER_THREADS, PLUGIN_INI_FILE_PATH);
+                if (count < 1)
+                {
+                    count = 1;
+                }
+                if (count > MAX_WORKER_THREADS)
+                {
+                    count = MAX_WORKER_THREADS;
+                }
+
+                g_queue = new WorkQueue();
+
+                for (UInt32 i = 0; i < count; i++)
+                {
+                    std::thread(WorkerLoop).detach();
+                }
+
+                _MESSAGE("Async: started %u worker threads", count);
+            }
+        }
+
+        Job::Job(Work work, SInt32 budgetMilliseconds)
+            : m_work(std::move(work)),
+              m_deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(budgetMilliseconds)),
+              m_hasDeadline(budgetMilliseconds > 0),
+              m_cancelled(false),
+              m_status(kJob_Pending)
+        {
+        }
+
+        bool Job::ShouldStop() const
+        {
+            return m_cancelled.load() || (m_hasDeadline && std::chrono::steady_clock::now() >= m_deadline);
+        }
+
+        SInt32 Job::Run()
+        {
+            // Time spent waiting in the queue counts against the budget
+            const bool finished = !ShouldStop() && m_work(*this);
+
+            SInt32 status = kJob_Done;
+            if (!finished)
+            {
+                status = m_cancelled.load() ? kJob_Cancelled : kJob_TimedOut;
+            }
+
+            // The work function owns captured copies of the inputs; free them now
+            m_work = nullptr;
+
+            m_status.store(status, std::memory_order_release);
+            return status;
+        }
+
+        void Submit(SInt32 handle, std::shared_ptr<Job> job)
+        {
+            std::call_once(g_startOnce, StartWorkers);
+
+            {
+                std::lock_guard<std::mutex> lock(g_queue->lock);
+
+                QueuedJob queued;
+                queued.handle = handle;
+                queued.session = g_session.load();
+                queued.job = std::move(job);
+                g_queue->jobs.push_back(std::move(queued));
+            }
+
+            g_queue->ready.notify_one();
+        }
+
+        void SetEventSink(EventSink sink)
+        {
+            g_eventSink.store(sink);
+        }
+
+        void EndSession()
+        {
+            g_session.fetch_add(1);
+        }
+
+        bool IsCurrentSession(UInt32 session)
+        {
+            return g_session.load() == session;
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+// ===================
+// Background Natives
+// ===================
+
+#include <atomic>                           // for std::atomic
+#include <chrono>                           // for std::chrono::steady_clock
+#include <functional>                       // for std::function
+#include <memory>                           // for std::shared_ptr
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+namespace Papyrus
+{
+    namespace Async
+    {
+        // Workers started on the first submit unless the INI says otherwise
+        constexpr UInt32 DEFAULT_WORKER_THREADS = 2;
+        constexpr UInt32 MAX_WORKER_THREADS = 8;
+
+        // Elements a work function handles between ShouldStop() polls
+        constexpr UInt32 CHECK_INTERVAL = 4096;
+
+        // Returned by AsyncStatus and passed to the completion event
+        enum JobStatus : SInt32
+        {
+            kJob_Pending = 0,
+            kJob_Done = 1,
+            kJob_Cancelled = 2,
+            kJob_TimedOut = 3,
+        };
+
+        // Called on a worker thread once a job leaves kJob_Pending. session
+        // is the one the job was submitted in; a sink that hands the event to
+        // another thread checks IsCurrentSession there before delivering it.
+        typedef void (*EventSink)(SInt32 handle, SInt32 status, UInt32 session);
+
+        // One piece of work for the pool. Inputs are copied into the work
+        // function before submission, so a job never touches VM memory.
+        //
+        // The work function returns false when ShouldStop() cut it short; the
+        // result fields are then left unread.
+        //
+        class Job
+        {
+        public:
+            typedef std::function<bool(Job&)> Work;
+
+            // budgetMilliseconds <= 0 means no time limit
+            //
+            Job(Work work, SInt32 budgetMilliseconds);
+
+            SInt32 Status() const { return m_status.load(std::memory_order_acquire); }
+
+            void Cancel() { m_cancelled.store(true); }
+
+            // True once the job was cancelled or ran past its budget. Work
+            // functions poll this between chunks, not per element.
+            //
+            bool ShouldStop() const;
+
+            // Runs the work unless the job was stopped while queued, then
+            // publishes and returns the final status. Called by a worker.
+            //
+            SInt32 Run();
+
+            // Filled in by the work function; only read once Status() is kJob_Done
+            std::string& Text() { return m_text; }
+            std::vector<std::string>& Parts() { return m_parts; }
+
+        private:
+            Work m_work;
+            std::chrono::steady_clock::time_point m_deadline;
+            bool m_hasDeadline;
+
+            std::atomic<bool> m_cancelled;
+            std::atomic<SInt32> m_status;
+
+            std::string m_text;
+            std::vector<std::string> m_parts;
+        };
+
+        // Queue a job under its Papyrus handle. The pool keeps its own
+        // reference, so closing the handle early is safe.
+        //
+        void Submit(SInt32 handle, std::shared_ptr<Job> job);
+
+        // Where completion events go. The game build forwards them to
+        // scripts through F4SE; nullptr (the default) drops them.
+        //
+        void SetEventSink(EventSink sink);
+
+        // Called when a save is loaded or a new game starts. No event is
+        // sent for any job submitted before the call; stopping those jobs is
+        // up to whoever holds them.
+        //
+        void EndSession();
+
+        bool IsCurrentSession(UInt32 session);
+    }
+}
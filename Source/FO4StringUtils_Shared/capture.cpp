@@ -0,0 +1,114 @@
+// ===================
+// Native Call Capture
+// ===================
+
+#include <cstdio>                           // for fopen, fwrite
+#include <mutex>                            // for std::mutex
+
+#include "functions.h"                      // for PAPYRUS_CLASS_NAME
+#include "capture.h"                        // for Capture
+#include "stats.h"                          // for Stats::FunctionName, Stats::MAX_FUNCTIONS
+
+namespace Papyrus
+{
+    namespace Capture
+    {
+        namespace
+        {
+            // Capture is a diagnostic mode, so one lock around the file is fine
+            std::mutex g_lock;
+            FILE* g_file = nullptr;
+
+            UInt64 g_written = 0;
+            UInt64 g_maxBytes = 0;
+            UInt64 g_unflushed = 0;
+
+            // Flush to disk this often so a crash loses little of the capture
+            constexpr UInt64 FLUSH_BYTES = 64 * 1024;
+
+            // Which ids already had their name written
+            bool g_announced[Stats::MAX_FUNCTIONS] = {};
+
+            // Caller must hold g_lock
+            //
+            void WriteRecord(RecordType type, UInt32 id, const char* payload, size_t payloadLen)
+            {
+                std::string header;
+                header.push_back(static_cast<char>(type));
+                PutVarint(header, id);
+                PutVarint(header, payloadLen);
+
+                fwrite(header.data(), 1, header.size(), g_file);
+                fwrite(payload, 1, payloadLen, g_file);
+
+                g_written += header.size() + payloadLen;
+                g_unflushed += header.size() + payloadLen;
+            }
+        }
+
+        bool Start(const std::string& path, UInt32 maxMegabytes)
+        {
+            std::lock_guard<std::mutex> lock(g_lock);
+
+            if (g_file)
+            {
+                return true;
+            }
+
+            g_file = fopen(path.c_str(), "wb");
+            if (!g_file)
+            {
+                _MESSAGE("%s capture could not open %s", PAPYRUS_CLASS_NAME, path.c_str());
+                return false;
+            }
+
+            const UInt32 header[2] = { FILE_MAGIC, FILE_VERSION };
+            fwrite(header, 1, sizeof(header), g_file);
+
+            g_written = sizeof(header);
+            g_maxBytes = static_cast<UInt64>(maxMegabytes ? maxMegabytes : DEFAULT_MAX_MEGABYTES) * 1024 * 1024;
+
+            _MESSAGE("%s capture writing to %s", PAPYRUS_CLASS_NAME, path.c_str());
+            return true;
+        }
+
+        void Record(UInt32 id, const std::string& args)
+        {
+            if (id >= Stats::MAX_FUNCTIONS)
+            {
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(g_lock);
+
+            if (!g_file)
+            {
+                return;
+            }
+
+            if (!g_announced[id])
+            {
+                const char* name = Stats::FunctionName(id);
+                WriteRecord(kRecord_Function, id, name, strlen(name));
+                g_announced[id] = true;
+            }
+
+            WriteRecord(kRecord_Call, id, args.data(), args.size());
+
+            // Size limit reached: close the file and ignore further calls
+            if (g_written >= g_maxBytes)
+            {
+                fclose(g_file);
+                g_file = nullptr;
+                _MESSAGE("%s capture stopped at %llu bytes", PAPYRUS_CLASS_NAME, static_cast<unsigned long long>(g_written));
+                return;
+            }
+
+            if (g_unflushed >= FLUSH_BYTES)
+            {
+                fflush(g_file);
+                g_unflushed = 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+// ===================
+// Native Call Capture
+// ===================
+
+// F4SE
+#include "f4se/PapyrusNativeFunctions.h"    // for BSFixedString, VMArray
+
+#include <cstring>                          // for memcpy, strlen
+#include <string>                           // for std::string
+
+namespace Papyrus
+{
+    namespace Capture
+    {
+        // File layout, all integers little endian:
+        //
+        //   header:   UInt32 FILE_MAGIC, UInt32 FILE_VERSION
+        //   records:  UInt8 type, varint function id, varint payload length, payload
+        //
+        // A kRecord_Function payload is the native's name and appears once per
+        // id before its first call. A kRecord_Call payload is UInt8 argument
+        // count followed by that many tagged arguments (see ArgType).
+        //
+        constexpr UInt32 FILE_MAGIC = 0x43555346;    // "FSUC"
+        constexpr UInt32 FILE_VERSION = 1;
+
+        // Stop writing once the file reaches this size unless the INI says otherwise
+        constexpr UInt32 DEFAULT_MAX_MEGABYTES = 256;
+
+        enum RecordType : UInt8
+        {
+            kRecord_Function = 1,
+            kRecord_Call = 2,
+        };
+
+        // Arrays are a varint count followed by the elements without tags.
+        // Strings are a varint byte length followed by the bytes.
+        enum ArgType : UInt8
+        {
+            kArg_Int = 1,           // SInt32
+            kArg_Bool = 2,          // UInt8
+            kArg_Float = 3,         // 32-bit IEEE float
+            kArg_String = 4,
+            kArg_IntArray = 5,
+            kArg_BoolArray = 6,
+            kArg_FloatArray = 7,
+            kArg_StringArray = 8,
+        };
+
+        // Open the capture file; later calls are ignored
+        //
+        bool Start(const std::string& path, UInt32 maxMegabytes);
+
+        // Append one call whose arguments were encoded with PutArgs
+        //
+        void Record(UInt32 id, const std::string& args);
+
+        inline void PutVarint(std::string& out, UInt64 value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        inline void PutRaw(std::string& out, const void* data, size_t size)
+        {
+            out.append(static_cast<const char*>(data), size);
+        }
+
+        inline void PutBytes(std::string& out, const char* str)
+        {
+            const size_t len = str ? strlen(str) : 0;
+            PutVarint(out, len);
+            PutRaw(out, str, len);
+        }
+
+        inline void PutArg(std::string& out, SInt32 value)
+        {
+            out.push_back(static_cast<char>(kArg_Int));
+            PutRaw(out, &value, sizeof(value));
+        }
+
+        inline void PutArg(std::string& out, bool value)
+        {
+            out.push_back(static_cast<char>(kArg_Bool));
+            out.push_back(value ? 1 : 0);
+        }
+
+        inline void PutArg(std::string& out, float value)
+        {
+            out.push_back(static_cast<char>(kArg_Float));
+            PutRaw(out, &value, sizeof(value));
+        }
+
+        inline void PutArg(std::string& out, const BSFixedString& value)
+        {
+            out.push_back(static_cast<char>(kArg_String));
+            PutBytes(out, value.c_str());
+        }
+
+        inline void PutArg(std::string& out, VMArray<SInt32>& value)
+        {
+            out.push_back(static_cast<char>(kArg_IntArray));
+            const UInt32 len = value.Length();
+            PutVarint(out, len);
+            for (UInt32 i = 0; i < len; i++)
+            {
+                SInt32 element = 0;
+                value.Get(&element, i);
+                PutRaw(out, &element, sizeof(element));
+            }
+        }
+
+        inline void PutArg(std::string& out, VMArray<bool>& value)
+        {
+            out.push_back(static_cast<char>(kArg_BoolArray));
+            const UInt32 len = value.Length();
+            PutVarint(out, len);
+            for (UInt32 i = 0; i < len; i++)
+            {
+                bool element = false;
+                value.Get(&element, i);
+                out.push_back(element ? 1 : 0);
+            }
+        }
+
+        inline void PutArg(std::string& out, VMArray<float>& value)
+        {
+            out.push_back(static_cast<char>(kArg_FloatArray));
+            const UInt32 len = value.Length();
+            PutVarint(out, len);
+            for (UInt32 i = 0; i < len; i++)
+            {
+                float element = 0.0f;
+                value.Get(&element, i);
+                PutRaw(out, &element, sizeof(element));
+            }
+        }
+
+        inline void PutArg(std::string& out, VMArray<BSFixedString>& value)
+        {
+            out.push_back(static_cast<char>(kArg_StringArray));
+            const UInt32 len = value.Length();
+            PutVarint(out, len);
+            for (UInt32 i = 0; i < len; i++)
+            {
+                BSFixedString element;
+                value.Get(&element, i);
+                PutBytes(out, element.c_str());
+            }
+        }
+
+        inline void PutEach(std::string& out)
+        {
+        }
+
+        template <typename T, typename... Rest>
+        inline void PutEach(std::string& out, T& first, Rest&... rest)
+        {
+            PutArg(out, first);
+            PutEach(out, rest...);
+        }
+
+        // Usage: std::string payload; Capture::PutArgs(payload, args...);
+        //
+        template <typename... A>
+        inline void PutArgs(std::string& out, A&... args)
+        {
+            out.push_back(static_cast<char>(sizeof...(A)));
+            PutEach(out, args...);
+        }
+    }
+}
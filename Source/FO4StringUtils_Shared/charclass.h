@@ -0,0 +1,289 @@
+#pragma once
+
+// =================
+// Character Classes
+// =================
+
+// Classification follows the "C" locale for bytes 0..127 and puts bytes 128..255
+// in no class at all, whatever locale the game happens to set. One table
+// lookup replaces the <cctype> call per character.
+
+#include <cstddef>                          // for size_t
+
+#include "simd.h"                           // for Simd
+
+namespace Papyrus
+{
+    // Bits of the Papyrus classMask argument; keep in sync with FO4StringUtils.psc
+    enum CharClass : UInt16
+    {
+        kCharClass_Alpha = 1 << 0,          // A-Z a-z
+        kCharClass_Digit = 1 << 1,          // 0-9
+        kCharClass_Hex = 1 << 2,            // 0-9 A-F a-f
+        kCharClass_Whitespace = 1 << 3,     // space \t \n \v \f \r
+        kCharClass_Punctuation = 1 << 4,    // graphic but not alphanumeric
+        kCharClass_Control = 1 << 5,        // 0-31 and 127
+        kCharClass_Printable = 1 << 6,      // 32-126
+        kCharClass_Graph = 1 << 7,          // 33-126
+        kCharClass_ASCII = 1 << 8,          // 0-127
+        kCharClass_Upper = 1 << 9,          // A-Z
+        kCharClass_Lower = 1 << 10,         // a-z
+
+        kCharClass_AlphaNumeric = kCharClass_Alpha | kCharClass_Digit,
+        kCharClass_All = (1 << 11) - 1,
+    };
+
+    struct CharClassTable
+    {
+        UInt16 classes[256];
+    };
+
+    constexpr UInt16 ClassifyChar(unsigned int c)
+    {
+        const bool upper = c >= 'A' && c <= 'Z';
+        const bool lower = c >= 'a' && c <= 'z';
+        const bool digit = c >= '0' && c <= '9';
+        const bool graph = c >= 33 && c <= 126;
+
+        return static_cast<UInt16>(
+            (upper || lower ? kCharClass_Alpha : 0) |
+            (digit ? kCharClass_Digit : 0) |
+            (digit || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f') ? kCharClass_Hex : 0) |
+            (c == ' ' || (c >= '\t' && c <= '\r') ? kCharClass_Whitespace : 0) |
+            (graph && !upper && !lower && !digit ? kCharClass_Punctuation : 0) |
+            (c < 32 || c == 127 ? kCharClass_Control : 0) |
+            (c >= 32 && c <= 126 ? kCharClass_Printable : 0) |
+            (graph ? kCharClass_Graph : 0) |
+            (c <= 127 ? kCharClass_ASCII : 0) |
+            (upper ? kCharClass_Upper : 0) |
+            (lower ? kCharClass_Lower : 0));
+    }
+
+    constexpr CharClassTable BuildCharClassTable()
+    {
+        CharClassTable table = {};
+        for (unsigned int c = 0; c < 256; c++)
+        {
+            table.classes[c] = ClassifyChar(c);
+        }
+        return table;
+    }
+
+    constexpr CharClassTable CHAR_CLASS_TABLE = BuildCharClassTable();
+
+    static_assert(CHAR_CLASS_TABLE.classes['a'] & kCharClass_Lower, "character class table was not built at compile time");
+
+    // Usage: if (IsCharOfClass<kCharClass_Digit>(c)) ...
+    //
+    template <UInt16 Mask>
+    inline bool IsCharOfClass(unsigned char c)
+    {
+        return (CHAR_CLASS_TABLE.classes[c] & Mask) != 0;
+    }
+
+    inline bool IsCharOfClass(unsigned char c, UInt16 mask)
+    {
+        return (CHAR_CLASS_TABLE.classes[c] & mask) != 0;
+    }
+
+    // Vector form of a class: Match sets every lane whose byte is in the class.
+    // Only classes that reduce to a few range compares get one; the rest fall
+    // back to the table.
+    //
+    template <UInt16 Mask>
+    struct CharClassKernel
+    {
+        static constexpr bool HAS_SIMD = false;
+    };
+
+#if PAPYRUS_SSE2
+    template <>
+    struct CharClassKernel<kCharClass_ASCII>
+    {
+        static constexpr bool HAS_SIMD = true;
+        static __m128i Match(__m128i v) { return Simd::IsASCII(v); }
+    };
+
+    template <>
+    struct CharClassKernel<kCharClass_Digit>
+    {
+        static constexpr bool HAS_SIMD = true;
+        static __m128i Match(__m128i v) { return Simd::InRange(v, '0', '9'); }
+    };
+
+    template <>
+    struct CharClassKernel<kCharClass_Upper>
+    {
+        static constexpr bool HAS_SIMD = true;
+        static __m128i Match(__m128i v) { return Simd::InRange(v, 'A', 'Z'); }
+    };
+
+    template <>
+    struct CharClassKernel<kCharClass_Lower>
+    {
+        static constexpr bool HAS_SIMD = true;
+        static __m128i Match(__m128i v) { return Simd::InRange(v, 'a', 'z'); }
+    };
+
+    template <>
+    struct CharClassKernel<kCharClass_Alpha>
+    {
+        static constexpr bool HAS_SIMD = true;
+
+        // Setting bit 5 folds A-Z onto a-z and keeps bytes 0x80+ negative
+        static __m128i Match(__m128i v) { return Simd::InRange(_mm_or_si128(v, Simd::Splat(0x20)), 'a', 'z'); }
+    };
+
+    template <>
+    struct CharClassKernel<kCharClass_AlphaNumeric>
+    {
+        static constexpr bool HAS_SIMD = true;
+
+        static __m128i Match(__m128i v)
+        {
+            return _mm_or_si128(CharClassKernel<kCharClass_Alpha>::Match(v), CharClassKernel<kCharClass_Digit>::Match(v));
+        }
+    };
+
+    template <>
+    struct CharClassKernel<kCharClass_Hex>
+    {
+        static constexpr bool HAS_SIMD = true;
+
+        static __m128i Match(__m128i v)
+        {
+            return _mm_or_si128(Simd::InRange(_mm_or_si128(v, Simd::Splat(0x20)), 'a', 'f'), Simd::InRange(v, '0', '9'));
+        }
+    };
+
+    template <>
+    struct CharClassKernel<kCharClass_Whitespace>
+    {
+        static constexpr bool HAS_SIMD = true;
+        static __m128i Match(__m128i v) { return _mm_or_si128(Simd::InRange(v, '\t', '\r'), Simd::Equal(v, ' ')); }
+    };
+
+    template <>
+    struct CharClassKernel<kCharClass_Control>
+    {
+        static constexpr bool HAS_SIMD = true;
+        static __m128i Match(__m128i v) { return _mm_or_si128(Simd::InRange(v, 0, 31), Simd::Equal(v, 127)); }
+    };
+
+    template <>
+    struct CharClassKernel<kCharClass_Printable>
+    {
+        static constexpr bool HAS_SIMD = true;
+        static __m128i Match(__m128i v) { return Simd::InRange(v, 32, 126); }
+    };
+
+    template <>
+    struct CharClassKernel<kCharClass_Graph>
+    {
+        static constexpr bool HAS_SIMD = true;
+        static __m128i Match(__m128i v) { return Simd::InRange(v, 33, 126); }
+    };
+
+    template <>
+    struct CharClassKernel<kCharClass_Punctuation>
+    {
+        static constexpr bool HAS_SIMD = true;
+
+        static __m128i Match(__m128i v)
+        {
+            return _mm_andnot_si128(CharClassKernel<kCharClass_AlphaNumeric>::Match(v), CharClassKernel<kCharClass_Graph>::Match(v));
+        }
+    };
+#endif
+
+    template <UInt16 Mask>
+    inline bool IsAllOfClassScalar(const char* str, size_t len)
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            if (!IsCharOfClass<Mask>(static_cast<unsigned char>(str[i])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <UInt16 Mask, bool HasSimd = CharClassKernel<Mask>::HAS_SIMD>
+    struct AllOfClass
+    {
+        static bool Test(const char* str, size_t len)
+        {
+            return IsAllOfClassScalar<Mask>(str, len);
+        }
+    };
+
+#if PAPYRUS_SSE2
+    template <UInt16 Mask>
+    struct AllOfClass<Mask, true>
+    {
+        static bool Test(const char* str, size_t len)
+        {
+            size_t i = 0;
+
+            // 16 characters per compare; any lane outside the class fails the string
+            for (; i + Simd::WIDTH <= len; i += Simd::WIDTH)
+            {
+                if (Simd::Mask(CharClassKernel<Mask>::Match(Simd::Load(str + i))) != Simd::FULL_MASK)
+                {
+                    return false;
+                }
+            }
+
+            return IsAllOfClassScalar<Mask>(str + i, len - i);
+        }
+    };
+#endif
+
+    // True if every character is in at least one class of Mask.
+    // An empty string is never "all" of anything.
+    //
+    template <UInt16 Mask>
+    inline bool IsAllOfClass(const char* str, size_t len)
+    {
+        return len != 0 && AllOfClass<Mask>::Test(str, len);
+    }
+
+    // Runtime mask version: single classes and AlphaNumeric use their vector
+    // kernel, any other combination walks the table once.
+    //
+    inline bool IsAllOfClass(const char* str, size_t len, UInt16 mask)
+    {
+        switch (mask)
+        {
+        case kCharClass_Alpha:          return IsAllOfClass<kCharClass_Alpha>(str, len);
+        case kCharClass_Digit:          return IsAllOfClass<kCharClass_Digit>(str, len);
+        case kCharClass_Hex:            return IsAllOfClass<kCharClass_Hex>(str, len);
+        case kCharClass_Whitespace:     return IsAllOfClass<kCharClass_Whitespace>(str, len);
+        case kCharClass_Punctuation:    return IsAllOfClass<kCharClass_Punctuation>(str, len);
+        case kCharClass_Control:        return IsAllOfClass<kCharClass_Control>(str, len);
+        case kCharClass_Printable:      return IsAllOfClass<kCharClass_Printable>(str, len);
+        case kCharClass_Graph:          return IsAllOfClass<kCharClass_Graph>(str, len);
+        case kCharClass_ASCII:          return IsAllOfClass<kCharClass_ASCII>(str, len);
+        case kCharClass_Upper:          return IsAllOfClass<kCharClass_Upper>(str, len);
+        case kCharClass_Lower:          return IsAllOfClass<kCharClass_Lower>(str, len);
+        case kCharClass_AlphaNumeric:   return IsAllOfClass<kCharClass_AlphaNumeric>(str, len);
+        default:
+            break;
+        }
+
+        if (len == 0 || mask == 0)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < len; i++)
+        {
+            if (!IsCharOfClass(static_cast<unsigned char>(str[i]), mask))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
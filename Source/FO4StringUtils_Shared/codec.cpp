@@ -0,0 +1,312 @@
+// ===================
+// Base64 and Hex Text
+// ===================
+
+#include "codec.h"                          // for Base64Encode
+#include "simd.h"                           // for Simd::Load
+
+namespace Papyrus
+{
+    namespace
+    {
+        const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+        // Marks bytes outside an alphabet in the decode tables
+        constexpr UInt8 INVALID_DIGIT = 0xFF;
+
+        struct DecodeTables
+        {
+            UInt8 base64[256];
+            UInt8 hex[256];
+
+            DecodeTables()
+            {
+                for (int i = 0; i < 256; i++)
+                {
+                    base64[i] = INVALID_DIGIT;
+                    hex[i] = INVALID_DIGIT;
+                }
+                for (int i = 0; i < 64; i++)
+                {
+                    base64[static_cast<UInt8>(BASE64_ALPHABET[i])] = static_cast<UInt8>(i);
+                }
+                for (int i = 0; i < 16; i++)
+                {
+                    hex[static_cast<UInt8>(HEX_DIGITS[i])] = static_cast<UInt8>(i);
+                    hex[static_cast<UInt8>(HEX_DIGITS[i] | 0x20)] = static_cast<UInt8>(i);
+                }
+            }
+        };
+
+        const DecodeTables g_decode;
+
+        inline void EncodeGroup(const UInt8* in, char* out)
+        {
+            const UInt32 group = (static_cast<UInt32>(in[0]) << 16) | (static_cast<UInt32>(in[1]) << 8) | in[2];
+            out[0] = BASE64_ALPHABET[(group >> 18) & 0x3F];
+            out[1] = BASE64_ALPHABET[(group >> 12) & 0x3F];
+            out[2] = BASE64_ALPHABET[(group >> 6) & 0x3F];
+            out[3] = BASE64_ALPHABET[group & 0x3F];
+        }
+
+#if PAPYRUS_SSE2
+        // SSE2 has no byte shuffle to index a table with, so the alphabet
+        // lookup is done as a sum of per-range offsets instead: each lane
+        // starts at +65 ('A') and every range boundary it passes adds the
+        // step to the next range.
+        //
+        inline __m128i SextetsToBase64(__m128i sextets)
+        {
+            __m128i offset = Simd::Splat(65);
+            offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(sextets, Simd::Splat(25)), Simd::Splat(6)));      // 'a' - 26
+            offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(sextets, Simd::Splat(51)), Simd::Splat(-75)));    // '0' - 52
+            offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(sextets, Simd::Splat(61)), Simd::Splat(-15)));    // '+' - 62
+            offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(sextets, Simd::Splat(62)), Simd::Splat(3)));      // '/' - 63
+            return _mm_add_epi8(sextets, offset);
+        }
+
+        // The inverse: each lane takes the offset of the one range it falls
+        // in. valid has every lane set only if all 16 were in the alphabet.
+        //
+        inline __m128i Base64ToSextets(__m128i text, UInt32& validMask)
+        {
+            const __m128i upper = Simd::InRange(text, 'A', 'Z');
+            const __m128i lower = Simd::InRange(text, 'a', 'z');
+            const __m128i digit = Simd::InRange(text, '0', '9');
+            const __m128i plus = Simd::Equal(text, '+');
+            const __m128i slash = Simd::Equal(text, '/');
+
+            validMask = Simd::Mask(_mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash));
+
+            __m128i offset = _mm_and_si128(upper, Simd::Splat(-65));
+            offset = _mm_or_si128(offset, _mm_and_si128(lower, Simd::Splat(-71)));
+            offset = _mm_or_si128(offset, _mm_and_si128(digit, Simd::Splat(4)));
+            offset = _mm_or_si128(offset, _mm_and_si128(plus, Simd::Splat(19)));
+            offset = _mm_or_si128(offset, _mm_and_si128(slash, Simd::Splat(16)));
+            return _mm_add_epi8(text, offset);
+        }
+
+        // Nibble values 0..15 to '0'..'9', 'A'..'F'
+        //
+        inline __m128i NibblesToHex(__m128i nibbles)
+        {
+            const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, Simd::Splat(9)), Simd::Splat(7));
+            return _mm_add_epi8(nibbles, _mm_add_epi8(Simd::Splat('0'), letters));
+        }
+
+        // Hex digits of either case to 0..15; valid as for Base64ToSextets
+        //
+        inline __m128i HexToNibbles(__m128i text, UInt32& validMask)
+        {
+            const __m128i digit = Simd::InRange(text, '0', '9');
+            const __m128i folded = _mm_or_si128(text, Simd::Splat(0x20));
+            const __m128i letter = Simd::InRange(folded, 'a', 'f');
+
+            validMask = Simd::Mask(_mm_or_si128(digit, letter));
+
+            const __m128i digitValue = _mm_sub_epi8(text, Simd::Splat('0'));
+            const __m128i letterValue = _mm_sub_epi8(folded, Simd::Splat('a' - 10));
+            return _mm_or_si128(_mm_and_si128(digit, digitValue), _mm_and_si128(letter, letterValue));
+        }
+#endif
+    }
+
+    std::string Base64Encode(const char* data, size_t length)
+    {
+        const UInt8* in = reinterpret_cast<const UInt8*>(data);
+        std::string text(((length + 2) / 3) * 4, '\0');
+        char* out = &text[0];
+        size_t i = 0;
+
+#if PAPYRUS_SSE2
+        // 12 bytes to 16 characters: split into sextets with scalar shifts,
+        // then translate all 16 at once
+        alignas(16) UInt8 sextets[Simd::WIDTH];
+        for (; i + 12 <= length; i += 12, out += Simd::WIDTH)
+        {
+            for (size_t g = 0; g < 4; g++)
+            {
+                const UInt8* p = in + i + g * 3;
+                const UInt32 group = (static_cast<UInt32>(p[0]) << 16) | (static_cast<UInt32>(p[1]) << 8) | p[2];
+                sextets[g * 4 + 0] = static_cast<UInt8>((group >> 18) & 0x3F);
+                sextets[g * 4 + 1] = static_cast<UInt8>((group >> 12) & 0x3F);
+                sextets[g * 4 + 2] = static_cast<UInt8>((group >> 6) & 0x3F);
+                sextets[g * 4 + 3] = static_cast<UInt8>(group & 0x3F);
+            }
+            Simd::Store(out, SextetsToBase64(_mm_load_si128(reinterpret_cast<const __m128i*>(sextets))));
+        }
+#endif
+        for (; i + 3 <= length; i += 3, out += 4)
+        {
+            EncodeGroup(in + i, out);
+        }
+
+        // One or two bytes left over, zero-filled and padded
+        if (i < length)
+        {
+            UInt8 tail[3] = { in[i], static_cast<UInt8>(i + 1 < length ? in[i + 1] : 0), 0 };
+            EncodeGroup(tail, out);
+            out[3] = '=';
+            if (i + 1 == length)
+            {
+                out[2] = '=';
+            }
+        }
+
+        return text;
+    }
+
+    bool Base64Decode(const char* text, size_t length, std::string& bytes)
+    {
+        // Up to two padding characters, only where they complete a group of four
+        size_t padding = 0;
+        if (length % 4 == 0)
+        {
+            while (padding < 2 && length > padding && text[length - padding - 1] == '=')
+            {
+                padding++;
+            }
+        }
+
+        const size_t digits = length - padding;
+        if (digits % 4 == 1)
+        {
+            return false;
+        }
+
+        bytes.assign(digits / 4 * 3 + (digits % 4 ? digits % 4 - 1 : 0), '\0');
+        UInt8* out = reinterpret_cast<UInt8*>(&bytes[0]);
+        size_t i = 0;
+
+#if PAPYRUS_SSE2
+        alignas(16) UInt8 sextets[Simd::WIDTH];
+        for (; i + Simd::WIDTH <= digits; i += Simd::WIDTH, out += 12)
+        {
+            UInt32 validMask;
+            _mm_store_si128(reinterpret_cast<__m128i*>(sextets), Base64ToSextets(Simd::Load(text + i), validMask));
+            if (validMask != Simd::FULL_MASK)
+            {
+                return false;
+            }
+
+            for (size_t g = 0; g < 4; g++)
+            {
+                const UInt8* s = sextets + g * 4;
+                const UInt32 group = (static_cast<UInt32>(s[0]) << 18) | (static_cast<UInt32>(s[1]) << 12) | (static_cast<UInt32>(s[2]) << 6) | s[3];
+                out[g * 3 + 0] = static_cast<UInt8>(group >> 16);
+                out[g * 3 + 1] = static_cast<UInt8>(group >> 8);
+                out[g * 3 + 2] = static_cast<UInt8>(group);
+            }
+        }
+#endif
+        UInt32 group = 0;
+        size_t pending = 0;
+        for (; i < digits; i++)
+        {
+            const UInt8 value = g_decode.base64[static_cast<UInt8>(text[i])];
+            if (value == INVALID_DIGIT)
+            {
+                return false;
+            }
+
+            group = (group << 6) | value;
+            if (++pending == 4)
+            {
+                *out++ = static_cast<UInt8>(group >> 16);
+                *out++ = static_cast<UInt8>(group >> 8);
+                *out++ = static_cast<UInt8>(group);
+                group = 0;
+                pending = 0;
+            }
+        }
+
+        // A final group of two or three digits holds one or two bytes
+        if (pending == 2)
+        {
+            *out++ = static_cast<UInt8>(group >> 4);
+        }
+        else if (pending == 3)
+        {
+            *out++ = static_cast<UInt8>(group >> 10);
+            *out++ = static_cast<UInt8>(group >> 2);
+        }
+
+        return true;
+    }
+
+    std::string HexEncode(const char* data, size_t length)
+    {
+        std::string text(length * 2, '\0');
+        char* out = &text[0];
+        size_t i = 0;
+
+#if PAPYRUS_SSE2
+        const __m128i lowNibble = Simd::Splat(0x0F);
+        for (; i + Simd::WIDTH <= length; i += Simd::WIDTH, out += 2 * Simd::WIDTH)
+        {
+            const __m128i v = Simd::Load(data + i);
+            const __m128i high = NibblesToHex(_mm_and_si128(_mm_srli_epi16(v, 4), lowNibble));
+            const __m128i low = NibblesToHex(_mm_and_si128(v, lowNibble));
+
+            // Interleave so each byte's high digit comes first
+            Simd::Store(out, _mm_unpacklo_epi8(high, low));
+            Simd::Store(out + Simd::WIDTH, _mm_unpackhi_epi8(high, low));
+        }
+#endif
+        for (; i < length; i++)
+        {
+            const UInt8 byte = static_cast<UInt8>(data[i]);
+            *out++ = HEX_DIGITS[byte >> 4];
+            *out++ = HEX_DIGITS[byte & 0x0F];
+        }
+
+        return text;
+    }
+
+    bool HexDecode(const char* text, size_t length, std::string& bytes)
+    {
+        if (length % 2 != 0)
+        {
+            return false;
+        }
+
+        bytes.assign(length / 2, '\0');
+        char* out = &bytes[0];
+        size_t i = 0;
+
+#if PAPYRUS_SSE2
+        const __m128i lowByte = _mm_set1_epi16(0x00FF);
+        for (; i + 2 * Simd::WIDTH <= length; i += 2 * Simd::WIDTH, out += Simd::WIDTH)
+        {
+            UInt32 validFirst;
+            UInt32 validSecond;
+            const __m128i first = HexToNibbles(Simd::Load(text + i), validFirst);
+            const __m128i second = HexToNibbles(Simd::Load(text + i + Simd::WIDTH), validSecond);
+            if ((validFirst & validSecond) != Simd::FULL_MASK)
+            {
+                return false;
+            }
+
+            // Each 16-bit lane holds a high digit in its low byte and a low
+            // digit in its high byte; combine them and pack the 16 results
+            const __m128i firstBytes = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(first, lowByte), 4), _mm_srli_epi16(first, 8));
+            const __m128i secondBytes = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(second, lowByte), 4), _mm_srli_epi16(second, 8));
+            Simd::Store(out, _mm_packus_epi16(firstBytes, secondBytes));
+        }
+#endif
+        for (; i < length; i += 2)
+        {
+            const UInt8 high = g_decode.hex[static_cast<UInt8>(text[i])];
+            const UInt8 low = g_decode.hex[static_cast<UInt8>(text[i + 1])];
+            if (high == INVALID_DIGIT || low == INVALID_DIGIT)
+            {
+                return false;
+            }
+
+            *out++ = static_cast<char>((high << 4) | low);
+        }
+
+        return true;
+    }
+}
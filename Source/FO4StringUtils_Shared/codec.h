@@ -0,0 +1,34 @@
+#pragma once
+
+// ===================
+// Base64 and Hex Text
+// ===================
+
+#include <string>                           // for std::string
+
+namespace Papyrus
+{
+    // Usage: std::string text = Base64Encode(bytes.data(), bytes.size());
+    //
+    // Standard alphabet with "=" padding.
+    //
+    std::string Base64Encode(const char* data, size_t length);
+
+    // Accepts padded or unpadded input in the standard alphabet; anything
+    // else, whitespace included, makes the whole decode fail.
+    //
+    // Returns false, leaving bytes unspecified, if text is not valid Base64.
+    //
+    bool Base64Decode(const char* text, size_t length, std::string& bytes);
+
+    // Two uppercase digits per byte
+    //
+    std::string HexEncode(const char* data, size_t length);
+
+    // Digits of either case, two per byte.
+    //
+    // Returns false, leaving bytes unspecified, for an odd length or a
+    // character that is not a hex digit.
+    //
+    bool HexDecode(const char* text, size_t length, std::string& bytes);
+}
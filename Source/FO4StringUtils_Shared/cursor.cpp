@@ -0,0 +1,65 @@
+// ==========================
+// Character Iteration Cursor
+// ==========================
+
+#include "charclass.h"                      // for IsCharOfClass
+#include "cursor.h"                         // for TextCursor
+
+namespace Papyrus
+{
+    std::string TextCursor::Next()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        if (m_position >= m_text.size())
+        {
+            return std::string();
+        }
+
+        return std::string(1, m_text[m_position++]);
+    }
+
+    SInt32 TextCursor::PeekOrdinal()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        if (m_position >= m_text.size())
+        {
+            return CURSOR_END;
+        }
+
+        return static_cast<SInt32>(static_cast<unsigned char>(m_text[m_position]));
+    }
+
+    SInt32 TextCursor::SkipWhile(UInt16 classMask)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        const size_t start = m_position;
+        while (m_position < m_text.size() && IsCharOfClass(static_cast<unsigned char>(m_text[m_position]), classMask))
+        {
+            m_position++;
+        }
+
+        return static_cast<SInt32>(m_position - start);
+    }
+
+    std::string TextCursor::TakeUntil(const std::string& delimiter)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        if (m_position >= m_text.size())
+        {
+            return std::string();
+        }
+
+        // Special case: empty delimiter -> take one character, as Split does
+        const size_t found = delimiter.empty() ? m_position + 1 : m_text.find(delimiter, m_position);
+        const size_t end = found == std::string::npos ? m_text.size() : found;
+
+        std::string token = m_text.substr(m_position, end - m_position);
+        m_position = found == std::string::npos ? m_text.size() : end + delimiter.size();
+
+        return token;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// ==========================
+// Character Iteration Cursor
+// ==========================
+
+#include <mutex>                            // for std::mutex
+#include <string>                           // for std::string
+#include <utility>                          // for std::move
+
+namespace Papyrus
+{
+    // Returned by PeekOrdinal once the cursor has passed the last character
+    constexpr SInt32 CURSOR_END = -1;
+
+    // One copy of a string plus a read position, so a script can walk the
+    // string in linear time instead of calling CharAt with a growing index.
+    //
+    // Positions are bytes, like CharAt and OrdinalAt. A handle may be shared
+    // between scripts on different VM threads, so every call takes the lock.
+    //
+    class TextCursor
+    {
+    public:
+        explicit TextCursor(std::string text) : m_text(std::move(text)) { }
+
+        // Returns the character at the position and moves past it, or an
+        // empty string at the end
+        //
+        std::string Next();
+
+        // Ordinal of the character at the position, or CURSOR_END
+        //
+        SInt32 PeekOrdinal();
+
+        // Moves past every character in one of the classMask classes.
+        // Returns how many characters were skipped.
+        //
+        SInt32 SkipWhile(UInt16 classMask);
+
+        // Returns the text up to the next delimiter and moves past the
+        // delimiter. Without a match the rest of the text is returned and
+        // the cursor ends up at the end.
+        //
+        std::string TakeUntil(const std::string& delimiter);
+
+    private:
+        std::mutex m_lock;
+        const std::string m_text;
+        size_t m_position = 0;
+    };
+}
@@ -0,0 +1,371 @@
+// ========================
+// Editable Text Documents
+// ========================
+
+#include <algorithm>                        // for std::min
+
+#include "document.h"                       // for TextDocument
+#include "functions.h"                      // for MAX_OUTPUT_SIZE, NOT_FOUND
+
+namespace Papyrus
+{
+    namespace
+    {
+        // Index of the empty tree; m_nodes[0] is a placeholder with total 0
+        constexpr UInt32 NO_NODE = 0;
+    }
+
+    TextDocument::TextDocument(std::string text) : m_original(std::move(text))
+    {
+        m_nodes.push_back(Node{ NO_NODE, NO_NODE, 0, 0, 0, 0, 0 });
+
+        if (!m_original.empty())
+        {
+            m_root = NewNode(false, 0, static_cast<UInt32>(m_original.size()));
+        }
+    }
+
+    UInt32 TextDocument::NewNode(bool added, UInt32 start, UInt32 length)
+    {
+        // xorshift32; the priorities only need to look random to keep the treap balanced
+        m_seed ^= m_seed << 13;
+        m_seed ^= m_seed >> 17;
+        m_seed ^= m_seed << 5;
+
+        const Node node{ NO_NODE, NO_NODE, m_seed, added ? 1u : 0u, start, length, length };
+
+        if (!m_freeNodes.empty())
+        {
+            const UInt32 index = m_freeNodes.back();
+            m_freeNodes.pop_back();
+            m_nodes[index] = node;
+            return index;
+        }
+
+        m_nodes.push_back(node);
+        return static_cast<UInt32>(m_nodes.size() - 1);
+    }
+
+    void TextDocument::FreeTree(UInt32 node)
+    {
+        if (node == NO_NODE)
+        {
+            return;
+        }
+
+        FreeTree(m_nodes[node].left);
+        FreeTree(m_nodes[node].right);
+        m_freeNodes.push_back(node);
+    }
+
+    UInt32 TextDocument::Total(UInt32 node) const
+    {
+        return m_nodes[node].total;
+    }
+
+    void TextDocument::Update(UInt32 node)
+    {
+        Node& n = m_nodes[node];
+        n.total = Total(n.left) + n.length + Total(n.right);
+    }
+
+    UInt32 TextDocument::Merge(UInt32 left, UInt32 right)
+    {
+        if (left == NO_NODE)
+        {
+            return right;
+        }
+        if (right == NO_NODE)
+        {
+            return left;
+        }
+
+        // The higher priority becomes the root; everything in left stays before right
+        if (m_nodes[left].priority > m_nodes[right].priority)
+        {
+            const UInt32 merged = Merge(m_nodes[left].right, right);
+            m_nodes[left].right = merged;
+            Update(left);
+            return left;
+        }
+
+        const UInt32 merged = Merge(left, m_nodes[right].left);
+        m_nodes[right].left = merged;
+        Update(right);
+        return right;
+    }
+
+    void TextDocument::Split(UInt32 tree, size_t position, UInt32& left, UInt32& right)
+    {
+        if (tree == NO_NODE)
+        {
+            left = NO_NODE;
+            right = NO_NODE;
+            return;
+        }
+
+        const size_t before = Total(m_nodes[tree].left);
+        const size_t length = m_nodes[tree].length;
+
+        if (position <= before)
+        {
+            UInt32 innerRight;
+            Split(m_nodes[tree].left, position, left, innerRight);
+            m_nodes[tree].left = innerRight;
+            Update(tree);
+            right = tree;
+        }
+        else if (position >= before + length)
+        {
+            UInt32 innerLeft;
+            Split(m_nodes[tree].right, position - before - length, innerLeft, right);
+            m_nodes[tree].right = innerLeft;
+            Update(tree);
+            left = tree;
+        }
+        else
+        {
+            // The position cuts this piece: the tail becomes a new node that
+            // leads the right-hand tree
+            const UInt32 cut = static_cast<UInt32>(position - before);
+            const UInt32 tail = NewNode(m_nodes[tree].added != 0, m_nodes[tree].start + cut, m_nodes[tree].length - cut);
+
+            const UInt32 rightChild = m_nodes[tree].right;
+            m_nodes[tree].length = cut;
+            m_nodes[tree].right = NO_NODE;
+            Update(tree);
+
+            left = tree;
+            right = Merge(tail, rightChild);
+        }
+    }
+
+    bool TextDocument::ExtendLast(UInt32 tree, UInt32 length)
+    {
+        if (tree == NO_NODE)
+        {
+            return false;
+        }
+
+        Node& node = m_nodes[tree];
+        if (node.right != NO_NODE)
+        {
+            if (!ExtendLast(node.right, length))
+            {
+                return false;
+            }
+        }
+        else if (!node.added || node.start + node.length != m_added.size() - length)
+        {
+            return false;
+        }
+        else
+        {
+            node.length += length;
+        }
+
+        node.total += length;
+        return true;
+    }
+
+    void TextDocument::InsertLocked(size_t position, const std::string& text)
+    {
+        if (text.empty())
+        {
+            return;
+        }
+
+        position = std::min<size_t>(position, Total(m_root));
+
+        const UInt32 start = static_cast<UInt32>(m_added.size());
+        const UInt32 length = static_cast<UInt32>(text.size());
+        m_added.append(text);
+
+        UInt32 left;
+        UInt32 right;
+        Split(m_root, position, left, right);
+
+        if (!ExtendLast(left, length))
+        {
+            left = Merge(left, NewNode(true, start, length));
+        }
+
+        m_root = Merge(left, right);
+    }
+
+    void TextDocument::DeleteLocked(size_t position, size_t count)
+    {
+        const size_t total = Total(m_root);
+        if (position >= total || count == 0)
+        {
+            return;
+        }
+
+        count = std::min(count, total - position);
+
+        UInt32 left;
+        UInt32 rest;
+        UInt32 middle;
+        UInt32 right;
+        Split(m_root, position, left, rest);
+        Split(rest, count, middle, right);
+
+        FreeTree(middle);
+        m_root = Merge(left, right);
+    }
+
+    void TextDocument::CompactIfWasteful()
+    {
+        const size_t total = Total(m_root);
+        if (m_added.size() <= MAX_OUTPUT_SIZE || m_added.size() <= total * 2)
+        {
+            return;
+        }
+
+        std::string text;
+        text.reserve(total);
+        auto append = [&text](const char* span, size_t length)
+        {
+            text.append(span, length);
+        };
+        ForEachSpan(m_root, 0, total, append);
+
+        FreeTree(m_root);
+        m_original.swap(text);
+        m_added.clear();
+        m_added.shrink_to_fit();
+        m_root = m_original.empty() ? NO_NODE : NewNode(false, 0, static_cast<UInt32>(m_original.size()));
+    }
+
+    template <typename F>
+    void TextDocument::ForEachSpan(UInt32 node, size_t position, size_t count, F& onSpan) const
+    {
+        // Walk only the subtrees that overlap [position, position + count)
+        while (node != NO_NODE && count > 0)
+        {
+            const Node& n = m_nodes[node];
+            const size_t before = Total(n.left);
+
+            if (position < before)
+            {
+                const size_t fromLeft = std::min(count, before - position);
+                ForEachSpan(n.left, position, fromLeft, onSpan);
+                position += fromLeft;
+                count -= fromLeft;
+            }
+
+            if (count > 0 && position < before + n.length)
+            {
+                const size_t offset = position - before;
+                const size_t take = std::min<size_t>(count, n.length - offset);
+                const std::string& buffer = n.added ? m_added : m_original;
+                onSpan(buffer.data() + n.start + offset, take);
+                position += take;
+                count -= take;
+            }
+
+            // The rest lies in the right subtree
+            position -= before + n.length;
+            node = n.right;
+        }
+    }
+
+    size_t TextDocument::Length()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return Total(m_root);
+    }
+
+    bool TextDocument::Insert(size_t position, const std::string& text)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        if (Total(m_root) + text.size() > MAX_OUTPUT_SIZE)
+        {
+            return false;
+        }
+
+        InsertLocked(position, text);
+        CompactIfWasteful();
+        return true;
+    }
+
+    void TextDocument::Delete(size_t position, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        DeleteLocked(position, count);
+    }
+
+    bool TextDocument::Replace(size_t position, size_t count, const std::string& text)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        const size_t total = Total(m_root);
+        position = std::min(position, total);
+        count = std::min(count, total - position);
+
+        if (total - count + text.size() > MAX_OUTPUT_SIZE)
+        {
+            return false;
+        }
+
+        DeleteLocked(position, count);
+        InsertLocked(position, text);
+        CompactIfWasteful();
+        return true;
+    }
+
+    std::string TextDocument::Substring(size_t position, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        const size_t total = Total(m_root);
+        if (position >= total)
+        {
+            return std::string();
+        }
+
+        count = std::min(count, total - position);
+
+        std::string result;
+        result.reserve(count);
+        auto append = [&result](const char* span, size_t length)
+        {
+            result.append(span, length);
+        };
+        ForEachSpan(m_root, position, count, append);
+
+        return result;
+    }
+
+    std::string TextDocument::ToString()
+    {
+        return Substring(0, MAX_OUTPUT_SIZE);
+    }
+
+    SInt32 TextDocument::Search(const std::string& foldedNeedle, size_t start)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        const size_t total = Total(m_root);
+        if (start > total || foldedNeedle.size() > total - start)
+        {
+            return NOT_FOUND;
+        }
+
+        // Fold the spans from start into one buffer and search that
+        std::string folded;
+        folded.reserve(total - start);
+        auto append = [&folded](const char* span, size_t length)
+        {
+            for (size_t i = 0; i < length; i++)
+            {
+                folded.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(span[i]))));
+            }
+        };
+        ForEachSpan(m_root, start, total - start, append);
+
+        const size_t found = folded.find(foldedNeedle);
+        return found == std::string::npos ? NOT_FOUND : static_cast<SInt32>(start + found);
+    }
+}
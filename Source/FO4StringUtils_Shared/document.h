@@ -0,0 +1,107 @@
+#pragma once
+
+// ========================
+// Editable Text Documents
+// ========================
+
+#include <mutex>                            // for std::mutex
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+namespace Papyrus
+{
+    // Text that scripts edit in place, stored as a piece table.
+    //
+    // The text is a sequence of pieces, each a span of either the original
+    // text or an append-only buffer holding everything inserted since. The
+    // pieces sit in a treap ordered by position, with each node keeping the
+    // byte length of its subtree, so finding, splitting and joining at a
+    // position takes O(log n) in the number of pieces. Inserting copies only
+    // the new text; deleting copies nothing. The whole text is only built
+    // when it is asked for.
+    //
+    // Positions are bytes, as for ReplaceIndex. A handle may be shared
+    // between scripts on different VM threads, so every call takes the lock.
+    //
+    class TextDocument
+    {
+    public:
+        explicit TextDocument(std::string text);
+
+        size_t Length();
+
+        // position is clamped to the text. Returns false, changing nothing,
+        // if the result would be longer than MAX_OUTPUT_SIZE.
+        //
+        bool Insert(size_t position, const std::string& text);
+
+        // The range is cut short at the end of the text
+        //
+        void Delete(size_t position, size_t count);
+
+        // Delete then Insert at the same position, as one step
+        //
+        bool Replace(size_t position, size_t count, const std::string& text);
+
+        std::string Substring(size_t position, size_t count);
+
+        std::string ToString();
+
+        // Case-insensitive, like SearchIndex. Returns NOT_FOUND if there is
+        // no match at or after start.
+        //
+        SInt32 Search(const std::string& foldedNeedle, size_t start);
+
+    private:
+        struct Node
+        {
+            UInt32 left;
+            UInt32 right;
+            UInt32 priority;
+            UInt32 added;       // 1 if the piece is in m_added, 0 for m_original
+            UInt32 start;       // first byte of the piece in its buffer
+            UInt32 length;      // bytes in the piece
+            UInt32 total;       // bytes in this subtree
+        };
+
+        UInt32 NewNode(bool added, UInt32 start, UInt32 length);
+        void FreeTree(UInt32 node);
+        UInt32 Total(UInt32 node) const;
+        void Update(UInt32 node);
+
+        UInt32 Merge(UInt32 left, UInt32 right);
+
+        // Splits tree into the first position bytes and the rest, cutting a
+        // piece in two if the position falls inside it
+        //
+        void Split(UInt32 tree, size_t position, UInt32& left, UInt32& right);
+
+        // Grows the last piece of tree if it ends where the added buffer
+        // does, so typing at one place keeps extending a single piece
+        //
+        bool ExtendLast(UInt32 tree, UInt32 length);
+
+        void InsertLocked(size_t position, const std::string& text);
+        void DeleteLocked(size_t position, size_t count);
+
+        // Calls onSpan(const char*, size_t) for the bytes in [position,
+        // position + count), in order
+        //
+        template <typename F>
+        void ForEachSpan(UInt32 node, size_t position, size_t count, F& onSpan) const;
+
+        // Rebuilds the table as one piece of original text once deleted
+        // insertions take up more room than the text itself
+        //
+        void CompactIfWasteful();
+
+        std::mutex m_lock;
+        std::string m_original;
+        std::string m_added;
+
+        std::vector<Node> m_nodes;          // index 0 is the empty tree
+        std::vector<UInt32> m_freeNodes;
+        UInt32 m_root = 0;
+        UInt32 m_seed = 2463534242u;
+    };
+}
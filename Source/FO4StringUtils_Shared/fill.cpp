@@ -0,0 +1,81 @@
+// ========================
+// Fill and Reverse Kernels
+// ========================
+
+#include <algorithm>                        // for std::min
+#include <cstring>                          // for memcpy, memset
+
+#include "fill.h"                           // for FillPattern
+#include "simd.h"                           // for Simd::Load
+
+namespace Papyrus
+{
+    namespace
+    {
+#if PAPYRUS_SSE2
+        // SSE2 has no byte shuffle, so the reversal is done in three steps:
+        // reverse the dwords, swap the words in each dword, then swap the
+        // bytes in each word
+        //
+        inline __m128i ReverseBytes(__m128i v)
+        {
+            v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+            v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+            v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+            return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        }
+#endif
+    }
+
+    void FillPattern(char* out, size_t length, const char* pattern, size_t patternLength)
+    {
+        if (length == 0 || patternLength == 0)
+        {
+            return;
+        }
+
+        if (patternLength == 1)
+        {
+            memset(out, pattern[0], length);
+            return;
+        }
+
+        // Each pass copies everything written so far, so the filled part is
+        // always a whole number of patterns
+        size_t filled = std::min(patternLength, length);
+        memcpy(out, pattern, filled);
+
+        while (filled < length && filled < FILL_BLOCK_SIZE)
+        {
+            const size_t chunk = std::min(filled, length - filled);
+            memcpy(out + filled, out, chunk);
+            filled += chunk;
+        }
+
+        // The first block now holds whole patterns; tile it the rest of the way
+        const size_t block = filled;
+        while (filled < length)
+        {
+            const size_t chunk = std::min(block, length - filled);
+            memcpy(out + filled, out, chunk);
+            filled += chunk;
+        }
+    }
+
+    void ReverseCopy(const char* in, size_t length, char* out)
+    {
+        size_t i = 0;
+
+#if PAPYRUS_SSE2
+        for (; i + Simd::WIDTH <= length; i += Simd::WIDTH)
+        {
+            Simd::Store(out + length - i - Simd::WIDTH, ReverseBytes(Simd::Load(in + i)));
+        }
+#endif
+
+        for (; i < length; i++)
+        {
+            out[length - 1 - i] = in[i];
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+// ========================
+// Fill and Reverse Kernels
+// ========================
+
+#include <cstddef>                          // for size_t
+
+namespace Papyrus
+{
+    // FillPattern doubles its output in place up to this many bytes, then
+    // copies that block forward, so every later copy reads from cache
+    constexpr size_t FILL_BLOCK_SIZE = static_cast<size_t>(16u) * 1024u;
+
+    // Writes pattern over out[0, length) again and again, cutting the last
+    // copy short if length is not a multiple of patternLength. A one-byte
+    // pattern is a memset.
+    //
+    void FillPattern(char* out, size_t length, const char* pattern, size_t patternLength);
+
+    // Writes in to out with the bytes in reverse order. The two must not
+    // overlap.
+    //
+    void ReverseCopy(const char* in, size_t length, char* out);
+}
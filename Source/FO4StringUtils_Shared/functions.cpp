@@ -7,20 +7,35 @@
 
 #include <algorithm>                        // for std::transform
 #include <cctype>                           // for std char type functions like std::isdigit
-#include <functional>                       // for std::function
+#include <cstring>                          // for strlen
+#include <memory>                           // for std::unique_ptr
 
 #include "version.h"                        // for version strings
 #include "functions.h"                      // for papyrus plugin functions
+#include "async.h"                          // for Async::Job
+#include "codec.h"                          // for Base64Encode
+#include "cursor.h"                         // for TextCursor
+#include "document.h"                       // for TextDocument
+#include "fill.h"                           // for FillPattern
+#include "handles.h"                        // for HandleRegistry
+#include "inifile.h"                        // for LoadDataIniFile
+#include "instrument.h"                     // for INSTRUMENT
+#include "json.h"                           // for JsonDocument
+#include "stats.h"                          // for Stats
+#include "trace.h"                          // for Trace
+#include "simd.h"                           // for Simd::Load
+#include "sourcecache.h"                    // for CachedSourceFor
+#include "stringset.h"                      // for FoldedStringSet
+#include "stringstable.h"                   // for StringsTable
+#include "textfile.h"                       // for OpenDataTextFile
+#include "textclean.h"                      // for SkipWhitespace
+#include "textindex.h"                      // for TextIndex
+#include "tokenize.h"                       // for SplitAnySpans
+#include "transform.h"                      // for TextTransform
+#include "utf8.h"                           // for Utf8ReverseCopy
 
 namespace Papyrus
 {
-    // Return if a character is a word separator
-    //
-    inline bool IsWordSeparator(char c)
-    {
-        return !std::isalpha(static_cast<unsigned char>(c));
-    }
-
     // Return if ordinal number is in a valid extended ASCII range
     //
     inline bool IsExtendedASCIIOrdinal(SInt32 ordinal)
@@ -28,28 +43,30 @@ namespace Papyrus
         return ordinal >= 0 && ordinal <= UPPER_BOUND_EXTENDED_ASCII;
     }
 
-    // Generic iteration over all characters of a string
+    // Generic check that every character of a string is in one of the mask classes
     //
-    inline bool IsAllFunction(const std::string& str, std::function<bool(unsigned char)> charCheck)
+    inline bool IsAllOfClassSource(const BSFixedString& sourceBS, UInt16 mask)
     {
-        // empty string does not match condition of all matching the check
-        if (str.empty())
-        {
-            return false;
-        }
-
-        // always cast to unsigned char for safety
-        for (unsigned char c : str)
+        // A source another native already cached remembers single-class answers
+        CachedSource* source = FindCachedSource(sourceBS);
+        if (source)
         {
-            // return false if we found a character not passing check
-            if (!charCheck(c))
+            if (mask != 0 && (mask & (mask - 1)) == 0)
             {
-                return false;
+                return source->IsAllOf(mask);
             }
+            return IsAllOfClass(source->Raw().data(), source->Length(), mask);
         }
 
-        // otherwise the entire string passes
-        return true;
+        // Otherwise read the interned characters in place, stopping at the first miss
+        const char* str = sourceBS.c_str();
+        return str && IsAllOfClass(str, strlen(str), mask);
+    }
+
+    template <UInt16 Mask>
+    inline bool IsAllFunction(const BSFixedString& sourceBS)
+    {
+        return IsAllOfClassSource(sourceBS, Mask);
     }
 
     // Usage: std::string sourceStr = FromBSFixedString(sourceBS);
@@ -67,22 +84,301 @@ namespace Papyrus
         return BSFixedString(str.c_str());
     }
 
-    inline std::string ToLowerCopy(const std::string& str)
+    // Usage: std::vector<std::string> parts = FromVMArray(arrayData);
+    //
+    inline std::vector<std::string> FromVMArray(VMArray<BSFixedString>& arrayData)
     {
-        std::string result;
-        result.reserve(str.size());
+        const UInt32 len = arrayData.Length();
+        std::vector<std::string> result;
+        result.reserve(len);
 
-        for (unsigned char c : str)
+        for (UInt32 i = 0; i < len; i++)
+        {
+            BSFixedString part;
+            arrayData.Get(&part, i);
+
+            // Defensive: null elements become empty strings so indexes line up
+            result.push_back(FromBSFixedString(part));
+        }
+
+        return result;
+    }
+
+    // Usage: return ToVMArray(parts);
+    //
+    inline VMArray<BSFixedString> ToVMArray(const std::vector<std::string>& parts)
+    {
+        VMArray<BSFixedString> result;
+
+        for (const std::string& part : parts)
         {
-            result.push_back(static_cast<char>(std::tolower(c)));
+            BSFixedString partBS = ToBSFixedString(part);
+            result.Push(&partBS);
         }
 
         return result;
     }
 
-    inline std::string NormalizeForSearch(const BSFixedString& sourceBS)
+    // Case-insensitive ReplaceAll into result in one left-to-right pass.
+    // folded and needle are lowercase; matches are found in folded and the
+    // raw text between them is copied. Returns false if shouldStop() did.
+    //
+    template <typename Stop>
+    bool ReplaceAllCopy(const std::string& raw, const std::string& folded, const std::string& needle, const std::string& replacement, std::string& result, Stop shouldStop)
+    {
+        size_t copied = 0;
+        size_t position = 0;
+        UInt32 matches = 0;
+
+        while ((position = folded.find(needle, copied)) != std::string::npos)
+        {
+            result.append(raw, copied, position - copied);
+            result.append(replacement);
+            copied = position + needle.length();
+
+            if (++matches % Async::CHECK_INTERVAL == 0 && shouldStop())
+            {
+                return false;
+            }
+        }
+
+        // Text after the last match
+        result.append(raw, copied, std::string::npos);
+        return true;
+    }
+
+    // Orders indexes by their lowercase keys, keeping equal keys in input
+    // order. Runs of CHECK_INTERVAL are sorted and then merged pairwise, so
+    // shouldStop() is polled between steps. Returns false if it stopped.
+    //
+    template <typename Stop>
+    bool StableSortByKeys(const std::vector<std::string>& keys, std::vector<UInt32>& order, Stop shouldStop)
+    {
+        const size_t length = order.size();
+        auto less = [&keys](UInt32 a, UInt32 b)
+        {
+            return keys[a].compare(keys[b]) < 0;
+        };
+
+        // Sort each run
+        for (size_t start = 0; start < length; start += Async::CHECK_INTERVAL)
+        {
+            const size_t end = std::min(length, start + Async::CHECK_INTERVAL);
+            std::stable_sort(order.begin() + start, order.begin() + end, less);
+
+            if (shouldStop())
+            {
+                return false;
+            }
+        }
+
+        // Merge neighbouring runs, doubling their width each pass
+        for (size_t width = Async::CHECK_INTERVAL; width < length; width *= 2)
+        {
+            for (size_t start = 0; start + width < length; start += width * 2)
+            {
+                const size_t end = std::min(length, start + width * 2);
+                std::inplace_merge(order.begin() + start, order.begin() + start + width, order.begin() + end, less);
+
+                if (shouldStop())
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // Folded key whose plain byte order is natural order: each digit run
+    // becomes '0' (so it still sorts where digits do), its significant
+    // length as four big-endian bytes, then its digits without leading
+    // zeros. "item 10" then follows "item 9" because the longer number
+    // compares greater at the length bytes. Digits never appear in the key
+    // outside an encoded run, so the marker cannot be confused with text.
+    //
+    inline std::string NaturalSortKey(const std::string& str)
+    {
+        std::string key;
+        key.reserve(str.size() + 8);
+
+        for (size_t i = 0; i < str.size();)
+        {
+            const unsigned char c = static_cast<unsigned char>(str[i]);
+            if (!std::isdigit(c))
+            {
+                key.push_back(static_cast<char>(std::tolower(c)));
+                i++;
+                continue;
+            }
+
+            size_t end = i;
+            while (end < str.size() && std::isdigit(static_cast<unsigned char>(str[end])))
+            {
+                end++;
+            }
+
+            // Keep one digit of an all-zero run so 0 still has a value
+            size_t first = i;
+            while (first + 1 < end && str[first] == '0')
+            {
+                first++;
+            }
+
+            const UInt32 digits = static_cast<UInt32>(end - first);
+            key.push_back('0');
+            key.push_back(static_cast<char>(digits >> 24));
+            key.push_back(static_cast<char>(digits >> 16));
+            key.push_back(static_cast<char>(digits >> 8));
+            key.push_back(static_cast<char>(digits));
+            key.append(str, first, digits);
+
+            i = end;
+        }
+
+        return key;
+    }
+
+    // Reads parts and orders their indexes by folded (or natural) key. Keys
+    // are built once up front, so the comparisons only compare bytes.
+    //
+    inline std::vector<UInt32> SortedOrder(VMArray<BSFixedString>& parts, std::vector<BSFixedString>& items, bool natural, bool descending, bool stable)
+    {
+        const UInt32 length = parts.Length();
+        items.resize(length);
+
+        std::vector<std::string> keys(length);
+        std::vector<UInt32> order(length);
+
+        for (UInt32 i = 0; i < length; ++i)
+        {
+            parts.Get(&items[i], i);
+            keys[i] = natural ? NaturalSortKey(FromBSFixedString(items[i])) : ToLowerCopy(FromBSFixedString(items[i]));
+            order[i] = i;
+        }
+
+        // Descending swaps the operands rather than reversing afterwards, so
+        // a stable sort still keeps equal keys in input order
+        auto less = [&keys, descending](UInt32 a, UInt32 b)
+        {
+            return descending ? keys[b].compare(keys[a]) < 0 : keys[a].compare(keys[b]) < 0;
+        };
+
+        if (stable)
+        {
+            std::stable_sort(order.begin(), order.end(), less);
+        }
+        else
+        {
+            std::sort(order.begin(), order.end(), less);
+        }
+
+        return order;
+    }
+
+    // Elements of a script array, keeping their interned entries so the set
+    // natives can return them as they came in
+    //
+    inline std::vector<BSFixedString> ElementsOf(VMArray<BSFixedString>& arrayData)
+    {
+        const UInt32 len = arrayData.Length();
+        std::vector<BSFixedString> elements(len);
+
+        for (UInt32 i = 0; i < len; i++)
+        {
+            arrayData.Get(&elements[i], i);
+        }
+
+        return elements;
+    }
+
+    // Text of an array element, with null read as ""
+    //
+    inline const char* ElementText(const BSFixedString& element)
+    {
+        const char* text = element.c_str();
+        return text ? text : "";
+    }
+
+    // First index in sorted whose element is not less than key (Upper false)
+    // or is greater than key (Upper true), by CompareFunction order. Only the
+    // O(log n) probed elements are read from the array.
+    //
+    template <bool Upper>
+    UInt32 SortedBound(VMArray<BSFixedString>& sorted, const BSFixedString& key)
+    {
+        const char* keyText = ElementText(key);
+        UInt32 first = 0;
+        UInt32 count = sorted.Length();
+
+        while (count > 0)
+        {
+            const UInt32 half = count / 2;
+            BSFixedString element;
+            sorted.Get(&element, first + half);
+
+            // One interned entry is one text, so the same pointer compares equal
+            const int order = element.data == key.data ? 0 : FoldedCompare(ElementText(element), keyText);
+            if (Upper ? order <= 0 : order < 0)
+            {
+                first += half + 1;
+                count -= half + 1;
+            }
+            else
+            {
+                count = half;
+            }
+        }
+
+        return first;
+    }
+
+    // Index of an element equal to key, or NOT_FOUND
+    //
+    inline SInt32 SortedFind(VMArray<BSFixedString>& sorted, const BSFixedString& key)
+    {
+        const UInt32 index = SortedBound<false>(sorted, key);
+        if (index == sorted.Length())
+        {
+            return NOT_FOUND;
+        }
+
+        BSFixedString element;
+        sorted.Get(&element, index);
+        return element.data == key.data || FoldedCompare(ElementText(element), ElementText(key)) == 0 ? static_cast<SInt32>(index) : NOT_FOUND;
+    }
+
+    // Open text indexes built by TextIndexBuild
+    HandleRegistry<TextIndex> g_textIndexes;
+
+    // Open cursors from CursorOpen
+    HandleRegistry<TextCursor> g_cursors;
+
+    // Editable documents from DocCreate
+    HandleRegistry<TextDocument> g_documents;
+
+    // Background jobs from the *Async natives, kept until AsyncClose
+    HandleRegistry<Async::Job> g_asyncJobs;
+
+    // Parsed documents from JsonParse and JsonParseFile
+    HandleRegistry<JsonDocument> g_jsonDocuments;
+
+    // Loaded configurations from IniLoad
+    HandleRegistry<IniFile> g_iniFiles;
+
+    // Open tables from StringsTableOpen
+    HandleRegistry<StringsTable> g_stringsTables;
+
+    // Usage: return SubmitAsyncJob(std::make_shared<Async::Job>(work, budgetMilliseconds));
+    //
+    inline SInt32 SubmitAsyncJob(std::shared_ptr<Async::Job> job)
     {
-        return ToLowerCopy(FromBSFixedString(sourceBS));
+        const SInt32 handle = g_asyncJobs.Add(job);
+        if (handle != INVALID_HANDLE)
+        {
+            Async::Submit(handle, std::move(job));
+        }
+        return handle;
     }
 
     BSFixedString PluginVersionFunction(StaticFunctionTag* base)
@@ -113,25 +409,20 @@ namespace Papyrus
 
     SInt32 CountFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        // Convert to C++ string for length
-        std::string sourceStr = FromBSFixedString(sourceBS);
-        return static_cast<SInt32>(sourceStr.length());
+        // Length is kept with the cached copy
+        return static_cast<SInt32>(CachedSourceFor(sourceBS).Length());
     }
 
     bool IsEmptyFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        // Convert to C++ string and check length
-        std::string sourceStr = FromBSFixedString(sourceBS);
-        return sourceStr.empty();
+        return CachedSourceFor(sourceBS).Length() == 0;
     }
 
     SInt32 CompareFunction(StaticFunctionTag* base, BSFixedString leftBS, BSFixedString rightBS)
     {
-        // Normalize to C++ strings
-        std::string leftStr = NormalizeForSearch(leftBS);
-        std::string rightStr = NormalizeForSearch(rightBS);
-        const size_t leftLen = leftStr.length();
-        const size_t rightLen = rightStr.length();
+        // Folded text is prepared once per string by the thread's source cache
+        const std::string& leftStr = CachedSourceFor(leftBS).Folded();
+        const std::string& rightStr = CachedSourceFor(rightBS).Folded();
 
         // Perform the comparison
         int cmp = leftStr.compare(rightStr);
@@ -155,9 +446,9 @@ namespace Papyrus
 
     SInt32 SearchFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString needleBS)
     {
-        // Normalize to C++ strings
-        std::string sourceStr = NormalizeForSearch(sourceBS);
-        std::string needleStr = NormalizeForSearch(needleBS);
+        // Folded text is prepared once per string by the thread's source cache
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Folded();
+        const std::string& needleStr = CachedSourceFor(needleBS).Folded();
         const size_t sourceLen = sourceStr.length();
         const size_t needleLen = needleStr.length();
 
@@ -211,9 +502,9 @@ namespace Papyrus
 
     SInt32 SearchReverseFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString needleBS)
     {
-        // Normalize to C++ strings
-        std::string sourceStr = NormalizeForSearch(sourceBS);
-        std::string needleStr = NormalizeForSearch(needleBS);
+        // Folded text is prepared once per string by the thread's source cache
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Folded();
+        const std::string& needleStr = CachedSourceFor(needleBS).Folded();
         const size_t sourceLen = sourceStr.length();
         const size_t needleLen = needleStr.length();
 
@@ -267,9 +558,9 @@ namespace Papyrus
 
     SInt32 SearchIndexFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString needleBS, SInt32 startIndex)
     {
-        // Normalize to C++ strings
-        std::string sourceStr = NormalizeForSearch(sourceBS);
-        std::string needleStr = NormalizeForSearch(needleBS);
+        // Folded text is prepared once per string by the thread's source cache
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Folded();
+        const std::string& needleStr = CachedSourceFor(needleBS).Folded();
         const size_t sourceLen = sourceStr.length();
         const size_t needleLen = needleStr.length();
 
@@ -340,9 +631,9 @@ namespace Papyrus
 
     SInt32 SearchIndexReverseFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString needleBS, SInt32 startIndex)
     {
-        // Normalize to C++ strings
-        std::string sourceStr = NormalizeForSearch(sourceBS);
-        std::string needleStr = NormalizeForSearch(needleBS);
+        // Folded text is prepared once per string by the thread's source cache
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Folded();
+        const std::string& needleStr = CachedSourceFor(needleBS).Folded();
         const size_t sourceLen = sourceStr.length();
         const size_t needleLen = needleStr.length();
 
@@ -410,11 +701,114 @@ namespace Papyrus
         return result;
     }
 
+    // Calls onMatch(position) for each match of needle in folded text, left
+    // to right in one pass. Non-overlapping matches resume after the end of
+    // the last one, as ReplaceAll does; overlapping ones one byte after its
+    // start. An empty needle matches nowhere.
+    //
+    template <typename F>
+    void ForEachMatch(const std::string& folded, const std::string& needle, bool overlapping, F onMatch)
+    {
+        if (needle.empty())
+        {
+            return;
+        }
+
+        const size_t step = overlapping ? 1 : needle.length();
+        for (size_t position = folded.find(needle); position != std::string::npos; position = folded.find(needle, position + step))
+        {
+            onMatch(position);
+        }
+    }
+
+    // Number of bytes equal to c. The SSE2 loop counts in byte lanes, which
+    // can hold 255 before they wrap, and folds them into the total with
+    // _mm_sad_epu8 at least that often.
+    //
+    inline size_t CountByte(const char* str, size_t len, char c)
+    {
+        size_t count = 0;
+        size_t i = 0;
+
+#if PAPYRUS_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        while (i + Simd::WIDTH <= len)
+        {
+            __m128i lanes = zero;
+            for (UInt32 block = 0; block < 255 && i + Simd::WIDTH <= len; block++, i += Simd::WIDTH)
+            {
+                // Matching lanes are -1, so subtracting adds one to each
+                lanes = _mm_sub_epi8(lanes, Simd::Equal(Simd::Load(str + i), c));
+            }
+
+            const __m128i sums = _mm_sad_epu8(lanes, zero);
+            count += static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+        }
+#endif
+        for (; i < len; i++)
+        {
+            count += str[i] == c;
+        }
+
+        return count;
+    }
+
+    VMArray<SInt32> FindAllFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString needleBS, bool overlapping)
+    {
+        // Both strings are folded once, rather than once per SearchIndex call
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Folded();
+        const std::string& needleStr = CachedSourceFor(needleBS).Folded();
+
+        VMArray<SInt32> result;
+        ForEachMatch(sourceStr, needleStr, overlapping, [&result](size_t position)
+        {
+            SInt32 index = static_cast<SInt32>(position);
+            result.Push(&index);
+        });
+
+        return result;
+    }
+
+    SInt32 CountOccurrencesFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString needleBS, bool overlapping)
+    {
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Folded();
+        const std::string& needleStr = CachedSourceFor(needleBS).Folded();
+
+        // A one-character needle never overlaps itself, so it can take the byte count
+        if (needleStr.length() == 1)
+        {
+            return static_cast<SInt32>(CountByte(sourceStr.data(), sourceStr.length(), needleStr[0]));
+        }
+
+        SInt32 count = 0;
+        ForEachMatch(sourceStr, needleStr, overlapping, [&count](size_t)
+        {
+            count++;
+        });
+
+        return count;
+    }
+
+    SInt32 CountCharFunction(StaticFunctionTag* base, BSFixedString sourceBS, SInt32 ordinal)
+    {
+        // Zero never appears inside a Papyrus string
+        if (ordinal <= 0 || !IsExtendedASCIIOrdinal(ordinal))
+        {
+            return 0;
+        }
+
+        // Case-insensitive like the other searches: count the folded character in the folded text
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Folded();
+        const char c = static_cast<char>(std::tolower(ordinal));
+
+        return static_cast<SInt32>(CountByte(sourceStr.data(), sourceStr.length(), c));
+    }
+
     bool ContainsFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString needleBS)
     {
-        // Normalize to C++ strings
-        std::string sourceStr = NormalizeForSearch(sourceBS);
-        std::string needleStr = NormalizeForSearch(needleBS);
+        // Folded text is prepared once per string by the thread's source cache
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Folded();
+        const std::string& needleStr = CachedSourceFor(needleBS).Folded();
         const size_t sourceLen = sourceStr.length();
         const size_t needleLen = needleStr.length();
 
@@ -452,9 +846,9 @@ namespace Papyrus
 
     bool StartsWithFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString prefixBS)
     {
-        // Normalize to C++ strings
-        std::string sourceStr = NormalizeForSearch(sourceBS);
-        std::string prefixStr = NormalizeForSearch(prefixBS);
+        // Folded text is prepared once per string by the thread's source cache
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Folded();
+        const std::string& prefixStr = CachedSourceFor(prefixBS).Folded();
         const size_t sourceLen = sourceStr.length();
         const size_t prefixLen = prefixStr.length();
 
@@ -485,9 +879,9 @@ namespace Papyrus
 
     bool EndsWithFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString suffixBS)
     {
-        // Normalize to C++ strings
-        std::string sourceStr = NormalizeForSearch(sourceBS);
-        std::string suffixStr = NormalizeForSearch(suffixBS);
+        // Folded text is prepared once per string by the thread's source cache
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Folded();
+        const std::string& suffixStr = CachedSourceFor(suffixBS).Folded();
         const size_t sourceLen = sourceStr.length();
         const size_t suffixLen = suffixStr.length();
 
@@ -518,10 +912,11 @@ namespace Papyrus
 
     BSFixedString ReplaceFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString needleBS, BSFixedString replacementBS)
     {
-        // Normalize and convert to C++ strings
-        std::string originalStr = FromBSFixedString(sourceBS);
-        std::string sourceStr = NormalizeForSearch(sourceBS);
-        std::string needleStr = NormalizeForSearch(needleBS);
+        // Search the cached folded text; only the output needs a fresh copy
+        CachedSource& source = CachedSourceFor(sourceBS);
+        std::string originalStr = source.Raw();
+        const std::string& sourceStr = source.Folded();
+        const std::string& needleStr = CachedSourceFor(needleBS).Folded();
         std::string replacementStr = FromBSFixedString(replacementBS);
         const size_t sourceLen = sourceStr.length();
         const size_t needleLen = needleStr.length();
@@ -546,36 +941,24 @@ namespace Papyrus
 
     BSFixedString ReplaceAllFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString needleBS, BSFixedString replacementBS)
     {
-        // Normalize and convert to C++ strings
-        std::string originalStr = FromBSFixedString(sourceBS);
-        std::string sourceStr = NormalizeForSearch(sourceBS);
-        std::string needleStr = NormalizeForSearch(needleBS);
-        std::string replacementStr = FromBSFixedString(replacementBS);
-        std::string replacementNorm = NormalizeForSearch(replacementBS);
-
-        const size_t sourceLen = sourceStr.length();
-        const size_t needleLen = needleStr.length();
-        const size_t replacementLen = replacementNorm.length();
+        // Cached text; matches are found in the folded copy
+        CachedSource& source = CachedSourceFor(sourceBS);
+        const std::string& needleStr = CachedSourceFor(needleBS).Folded();
+        const std::string& replacementStr = CachedSourceFor(replacementBS).Raw();
 
         // Special case: empty old string -> nothing to replace
-        if (sourceLen == 0 || needleLen == 0)
+        if (source.Length() == 0 || needleStr.empty())
         {
             // Return original string unchanged
             return sourceBS;
         }
 
         // Perform replacement
-        size_t position = 0;
-        while ((position = sourceStr.find(needleStr, position)) != std::string::npos)
-        {
-            originalStr.replace(position, needleLen, replacementStr);
-            sourceStr.replace(position, needleLen, replacementNorm);
-
-            position += replacementLen; // move past replacement
-        }
+        std::string resultStr;
+        ReplaceAllCopy(source.Raw(), source.Folded(), needleStr, replacementStr, resultStr, [] { return false; });
 
         // Return the result string
-        return ToBSFixedString(originalStr.c_str());
+        return ToBSFixedString(resultStr);
     }
 
     BSFixedString ReplaceIndexFunction(StaticFunctionTag* base, BSFixedString sourceBS, SInt32 startIndex, SInt32 count, BSFixedString replacementBS)
@@ -620,10 +1003,94 @@ namespace Papyrus
         return ToBSFixedString(sourceStr);
     }
 
+    BSFixedString ApplyEditsFunction(StaticFunctionTag* base, BSFixedString sourceBS, VMArray<SInt32> starts, VMArray<SInt32> counts, VMArray<BSFixedString> replacements)
+    {
+        struct Edit
+        {
+            size_t start;
+            size_t count;
+            BSFixedString replacement;
+            size_t replacementLen;
+        };
+
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
+        const size_t sourceLen = sourceStr.length();
+        const UInt32 editCount = starts.Length();
+
+        // Every edit needs all three parts
+        if (counts.Length() != editCount || replacements.Length() != editCount)
+        {
+            return sourceBS;
+        }
+
+        std::vector<Edit> edits(editCount);
+        size_t resultLen = sourceLen;
+
+        for (UInt32 i = 0; i < editCount; i++)
+        {
+            SInt32 start = 0;
+            SInt32 count = 0;
+            starts.Get(&start, i);
+            counts.Get(&count, i);
+            replacements.Get(&edits[i].replacement, i);
+
+            // Offsets are into the original string; a range past its end is
+            // cut short there, as ReplaceIndex does
+            if (start < 0 || count < 0 || static_cast<size_t>(start) > sourceLen)
+            {
+                return sourceBS;
+            }
+
+            edits[i].start = static_cast<size_t>(start);
+            edits[i].count = std::min(static_cast<size_t>(count), sourceLen - edits[i].start);
+
+            edits[i].replacementLen = strlen(ElementText(edits[i].replacement));
+
+            resultLen = resultLen - edits[i].count + edits[i].replacementLen;
+        }
+
+        // Stable, so insertions at one position keep the order they were
+        // given in; they go before a range that starts at the same place
+        std::stable_sort(edits.begin(), edits.end(), [](const Edit& a, const Edit& b)
+        {
+            return a.start != b.start ? a.start < b.start : (a.count == 0 && b.count != 0);
+        });
+
+        for (size_t i = 1; i < edits.size(); i++)
+        {
+            if (edits[i].start < edits[i - 1].start + edits[i - 1].count)
+            {
+                // Overlapping ranges have no single meaning
+                return sourceBS;
+            }
+        }
+
+        if (resultLen > MAX_OUTPUT_SIZE)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        // Copy the untouched text and each replacement in order into a
+        // buffer sized for the result up front
+        std::string result;
+        result.reserve(resultLen);
+        size_t copied = 0;
+
+        for (const Edit& edit : edits)
+        {
+            result.append(sourceStr, copied, edit.start - copied);
+            result.append(ElementText(edit.replacement), edit.replacementLen);
+            copied = edit.start + edit.count;
+        }
+        result.append(sourceStr, copied, std::string::npos);
+
+        return ToBSFixedString(result);
+    }
+
     BSFixedString SubstringFunction(StaticFunctionTag* base, BSFixedString sourceBS, SInt32 startIndex, SInt32 count)
     {
-        // Convert source to std::string for safe manipulation
-        std::string sourceStr = FromBSFixedString(sourceBS);
+        // Read from the cached copy; substr makes the only new string
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
         const size_t sourceLen = sourceStr.length();
 
         // No source string to extract from
@@ -726,8 +1193,8 @@ namespace Papyrus
 
     SInt32 ToOrdinalFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        // Convert to C++ string
-        std::string sourceStr = FromBSFixedString(sourceBS);
+        // Cached copy; nothing is modified
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
         const size_t sourceLen = sourceStr.length();
 
         // empty string check
@@ -746,16 +1213,28 @@ namespace Papyrus
 
     SInt32 OrdinalAtFunction(StaticFunctionTag* base, BSFixedString sourceBS, SInt32 startIndex)
     {
-       // convert to ordinal and will be -1 if string empty or out-of-bounds
-        return ToOrdinalFunction(base, CharAtFunction(base, sourceBS, startIndex)); 
-    }
+        // Read the byte in place instead of building a one-character string
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
 
-    BSFixedString RemoveFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString targetBS)
-    {
-        // Normalize and convert to C++ strings for safe manipulation
-        std::string originalStr = FromBSFixedString(sourceBS);
-        std::string sourceStr = NormalizeForSearch(sourceBS);
-        std::string targetStr = NormalizeForSearch(targetBS);
+        // Same clamping as CharAt: negative indexes read the first character
+        const size_t index = startIndex < 0 ? 0 : static_cast<size_t>(startIndex);
+
+        // -1 if string empty or out-of-bounds
+        if (index >= sourceStr.length())
+        {
+            return NOT_FOUND;
+        }
+
+        return static_cast<SInt32>(static_cast<unsigned char>(sourceStr[index]));
+    }
+
+    BSFixedString RemoveFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString targetBS)
+    {
+        // Search the cached folded text; only the output needs a fresh copy
+        CachedSource& source = CachedSourceFor(sourceBS);
+        std::string originalStr = source.Raw();
+        const std::string& sourceStr = source.Folded();
+        const std::string& targetStr = CachedSourceFor(targetBS).Folded();
         const size_t sourceLen = sourceStr.length();
         const size_t targetLen = targetStr.length();
 
@@ -779,10 +1258,11 @@ namespace Papyrus
 
     BSFixedString RemoveAllFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString targetBS)
     {
-        // Normalize and convert to C++ strings for safe manipulation
-        std::string originalStr = FromBSFixedString(sourceBS);
-        std::string sourceStr = NormalizeForSearch(sourceBS);
-        std::string targetStr = NormalizeForSearch(targetBS);
+        // Working copies of the cached text; the folded copy is edited in step
+        CachedSource& source = CachedSourceFor(sourceBS);
+        std::string originalStr = source.Raw();
+        std::string sourceStr = source.Folded();
+        const std::string& targetStr = CachedSourceFor(targetBS).Folded();
         const size_t sourceLen = sourceStr.length();
         const size_t targetLen = targetStr.length();
 
@@ -806,30 +1286,40 @@ namespace Papyrus
         return ToBSFixedString(originalStr);
     }
 
+    // Interns a length-byte string written in place by write(char* out).
+    // The buffer is not cleared first, so write must fill all of it; large
+    // outputs are then written once and copied once, by the intern.
+    //
+    template <typename Writer>
+    inline BSFixedString BuildFixedString(size_t length, Writer write)
+    {
+        std::unique_ptr<char[]> buffer(new char[length + 1]);
+        write(buffer.get());
+        buffer[length] = '\0';
+
+        return BSFixedString(buffer.get());
+    }
+
     BSFixedString ReverseFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        // Convert to C++ string for manipulation
-        std::string sourceStr = FromBSFixedString(sourceBS);
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
         const size_t sourceLen = sourceStr.length();
 
-        // Empty string in then empty string out
-        if (sourceLen == 0)
+        // A single byte reads the same either way
+        if (sourceLen < 2)
         {
-            // Return empty string
-            return ToBSFixedString(EMPTY_STRING);
+            return sourceLen == 0 ? ToBSFixedString(EMPTY_STRING) : sourceBS;
         }
 
-        // Reverse the string
-        std::reverse(sourceStr.begin(), sourceStr.end());
-
-        // Return the result string
-        return ToBSFixedString(sourceStr);
+        return BuildFixedString(sourceLen, [&sourceStr, sourceLen](char* out)
+        {
+            ReverseCopy(sourceStr.data(), sourceLen, out);
+        });
     }
 
     BSFixedString RepeatFunction(StaticFunctionTag* base, BSFixedString sourceBS, SInt32 count)
     {
-        // Setup the string
-        std::string sourceStr = FromBSFixedString(sourceBS);
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
         const size_t sourceLen = sourceStr.length();
 
         // Non-positive repeat → empty string
@@ -840,171 +1330,273 @@ namespace Papyrus
         }
 
         // Prevent overflow & runaway memory use
-        if (sourceLen > MAX_OUTPUT_SIZE || count > MAX_OUTPUT_SIZE || (sourceLen * count) > MAX_OUTPUT_SIZE)
+        if (sourceLen > MAX_OUTPUT_SIZE / static_cast<size_t>(count))
         {
             return ToBSFixedString(EMPTY_STRING);
         }
 
-        // Build output efficiently
-        std::string outStr;
-        outStr.reserve(sourceLen * count); // optional, avoids reallocs
-
-        for (int i = 0; i < count; ++i)
+        if (count == 1)
         {
-            outStr.append(sourceStr); // append the whole string
+            return sourceBS;
         }
 
-        // Return the result string
-        return ToBSFixedString(outStr.c_str());
+        const size_t resultLen = sourceLen * count;
+        return BuildFixedString(resultLen, [&sourceStr, sourceLen, resultLen](char* out)
+        {
+            FillPattern(out, resultLen, sourceStr.data(), sourceLen);
+        });
     }
 
-    BSFixedString TrimStartFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    // Where PadToWidth puts the fill
+    enum PadFill
     {
-        // Convert to C++ string for manipulation
-        std::string sourceStr = FromBSFixedString(sourceBS);
+        kPadFill_Left,              // PadLeft: source ends up on the right
+        kPadFill_Right,             // PadRight: source ends up on the left
+        kPadFill_Both,              // Center: the odd fill byte goes on the right
+    };
+
+    // Widens source to width bytes with the first byte of fillChar, or a
+    // space if fillChar is empty. A source already that wide comes back as
+    // it is, and a width over MAX_OUTPUT_SIZE gives an empty string.
+    //
+    BSFixedString PadToWidth(const BSFixedString& sourceBS, SInt32 width, const BSFixedString& fillCharBS, PadFill side)
+    {
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
         const size_t sourceLen = sourceStr.length();
 
-        // Empty string in then empty string out
-        if (sourceLen == 0)
+        if (width <= 0 || static_cast<size_t>(width) <= sourceLen)
         {
-            // Return empty string
-            return ToBSFixedString(EMPTY_STRING);
+            return sourceBS;
         }
 
-        // Find first non-whitespace character
-        size_t start = sourceStr.find_first_not_of(WHITESPACE_CHARS);
-        if (start == std::string::npos)
+        const size_t resultLen = static_cast<size_t>(width);
+        if (resultLen > MAX_OUTPUT_SIZE)
         {
-            // String is all whitespace; clear it
-            sourceStr.clear();
+            return ToBSFixedString(EMPTY_STRING);
         }
-        else
+
+        const char* fillChars = fillCharBS.c_str();
+        const char fill = (fillChars && fillChars[0]) ? fillChars[0] : ' ';
+
+        const size_t padding = resultLen - sourceLen;
+        const size_t before = side == kPadFill_Left ? padding : side == kPadFill_Both ? padding / 2 : 0;
+
+        return BuildFixedString(resultLen, [&sourceStr, sourceLen, padding, before, fill](char* out)
         {
-            // Trim leading whitespace
-            sourceStr = sourceStr.substr(start);
-        }
+            FillPattern(out, before, &fill, 1);
+            memcpy(out + before, sourceStr.data(), sourceLen);
+            FillPattern(out + before + sourceLen, padding - before, &fill, 1);
+        });
+    }
 
-        // Return the result string
-        return ToBSFixedString(sourceStr);
+    BSFixedString PadLeftFunction(StaticFunctionTag* base, BSFixedString sourceBS, SInt32 width, BSFixedString fillCharBS)
+    {
+        return PadToWidth(sourceBS, width, fillCharBS, kPadFill_Left);
     }
 
-    BSFixedString TrimEndFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    BSFixedString PadRightFunction(StaticFunctionTag* base, BSFixedString sourceBS, SInt32 width, BSFixedString fillCharBS)
     {
-        // Convert to C++ string for manipulation
-        std::string sourceStr = FromBSFixedString(sourceBS);
-        const size_t sourceLen = sourceStr.length();
+        return PadToWidth(sourceBS, width, fillCharBS, kPadFill_Right);
+    }
 
-        // Empty string in then empty string out
-        if (sourceLen == 0)
+    BSFixedString CenterFunction(StaticFunctionTag* base, BSFixedString sourceBS, SInt32 width, BSFixedString fillCharBS)
+    {
+        return PadToWidth(sourceBS, width, fillCharBS, kPadFill_Both);
+    }
+
+    // The [start, end) part of a cached source as a Papyrus string. The
+    // whole source is handed back as it is and a part running to the end is
+    // interned straight from the cached text, so only a part cut short at
+    // the end is copied first.
+    //
+    inline BSFixedString SourceRange(const BSFixedString& sourceBS, const std::string& sourceStr, size_t start, size_t end)
+    {
+        if (end == sourceStr.length())
         {
-            // Return empty string
-            return ToBSFixedString(EMPTY_STRING);
+            return start == 0 ? sourceBS : BSFixedString(sourceStr.c_str() + start);
         }
 
-        // Find the last non-whitespace character
-        size_t end = sourceStr.find_last_not_of(WHITESPACE_CHARS);
+        return ToBSFixedString(sourceStr.substr(start, end - start));
+    }
 
-        // If the string is all whitespace
-        if (end == std::string::npos)
-        {
-            // clear it
-            sourceStr.clear();
-        }
-        else
-        {
-            // trim the end
-            sourceStr = sourceStr.substr(0, end + 1);
-        }
+    BSFixedString TrimStartFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
+        const size_t start = SkipWhitespace(sourceStr.data(), sourceStr.length());
 
-        // Return the result string
-        return ToBSFixedString(sourceStr);
+        return SourceRange(sourceBS, sourceStr, start, sourceStr.length());
+    }
+
+    BSFixedString TrimEndFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
+        const size_t end = TrimmedEnd(sourceStr.data(), sourceStr.length());
+
+        return SourceRange(sourceBS, sourceStr, 0, end);
     }
 
     BSFixedString TrimBothFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        // Convert to C++ string for manipulation
-        std::string sourceStr = FromBSFixedString(sourceBS);
-        const size_t sourceLen = sourceStr.length();
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
+        const size_t start = SkipWhitespace(sourceStr.data(), sourceStr.length());
 
-        // Empty string in then empty string out
-        if (sourceLen == 0)
-        {
-            // Return empty string
-            return ToBSFixedString(EMPTY_STRING);
-        }
+        // The end search stops at start, so an all-whitespace string is scanned once
+        const size_t end = start + TrimmedEnd(sourceStr.data() + start, sourceStr.length() - start);
+
+        return SourceRange(sourceBS, sourceStr, start, end);
+    }
+
+    BSFixedString CollapseWhitespaceFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
+
+        // Collapsing never lengthens the text
+        std::string resultStr(sourceStr.length(), '\0');
+        bool inRun = false;
+        char* const resultEnd = CollapseWhitespaceCopy(sourceStr.data(), sourceStr.length(), &resultStr[0], inRun);
+        resultStr.resize(resultEnd - resultStr.data());
+
+        return ToBSFixedString(resultStr);
+    }
 
-        // Find first non-whitespace character
-        size_t start = sourceStr.find_first_not_of(WHITESPACE_CHARS);
+    BSFixedString StripControlFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
 
-        // Find last non-whitespace character
-        size_t end = sourceStr.find_last_not_of(WHITESPACE_CHARS);
+        std::string resultStr(sourceStr.length(), '\0');
+        char* const resultEnd = StripControlCopy(sourceStr.data(), sourceStr.length(), &resultStr[0]);
+        resultStr.resize(resultEnd - resultStr.data());
 
-        // If string is all whitespace, clear
-        if (start == std::string::npos || end == std::string::npos)
+        // Nothing removed; the source is already the answer
+        if (resultStr.length() == sourceStr.length())
         {
-            sourceStr.clear();
+            return sourceBS;
         }
-        else
+
+        return ToBSFixedString(resultStr);
+    }
+
+    BSFixedString TransformFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString opSpecBS)
+    {
+        // Compiled once per spec string, then reused for every call with it
+        const TextTransform& transform = CompiledTransformFor(opSpecBS);
+        if (!transform.IsValid())
         {
-            // Extract trimmed substring
-            sourceStr = sourceStr.substr(start, end - start + 1);
+            // An unknown op leaves the source as it was
+            return sourceBS;
         }
 
-        // Return the result string
-        return ToBSFixedString(sourceStr);
+        return ToBSFixedString(transform.Apply(CachedSourceFor(sourceBS).Raw()));
     }
 
     bool IsAlphaFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        return IsAllFunction(FromBSFixedString(sourceBS), ::isalpha);
+        return IsAllFunction<kCharClass_Alpha>(sourceBS);
     }
 
     bool IsDigitFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        return IsAllFunction(FromBSFixedString(sourceBS), ::isdigit);
+        return IsAllFunction<kCharClass_Digit>(sourceBS);
     }
 
     bool IsHexFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        return IsAllFunction(FromBSFixedString(sourceBS), ::isxdigit);
+        return IsAllFunction<kCharClass_Hex>(sourceBS);
     }
 
     bool IsAlphaNumericFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        return IsAllFunction(FromBSFixedString(sourceBS), ::isalnum);
+        return IsAllFunction<kCharClass_AlphaNumeric>(sourceBS);
     }
 
     bool IsWhitespaceFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        return IsAllFunction(FromBSFixedString(sourceBS), ::isspace);
+        return IsAllFunction<kCharClass_Whitespace>(sourceBS);
     }
 
     bool IsPunctuationFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        return IsAllFunction(FromBSFixedString(sourceBS), ::ispunct);
+        return IsAllFunction<kCharClass_Punctuation>(sourceBS);
     }
 
     bool IsASCIIFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        return IsAllFunction(FromBSFixedString(sourceBS), [](unsigned char c)
-        {
-            return c <= UPPER_BOUND_ASCII;
-        });
+        return IsAllFunction<kCharClass_ASCII>(sourceBS);
     }
 
     bool IsControlFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        return IsAllFunction(FromBSFixedString(sourceBS), ::iscntrl);
+        return IsAllFunction<kCharClass_Control>(sourceBS);
     }
 
     bool IsPrintableFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        return IsAllFunction(FromBSFixedString(sourceBS), ::isprint);
+        return IsAllFunction<kCharClass_Printable>(sourceBS);
     }
 
     bool IsGraphFunction(StaticFunctionTag* base, BSFixedString sourceBS)
     {
-        return IsAllFunction(FromBSFixedString(sourceBS), ::isgraph);
+        return IsAllFunction<kCharClass_Graph>(sourceBS);
+    }
+
+    bool IsAllOfClassFunction(StaticFunctionTag* base, BSFixedString sourceBS, SInt32 classMask)
+    {
+        // Bits past the last defined class are ignored
+        const UInt16 mask = static_cast<UInt16>(classMask & kCharClass_All);
+
+        return IsAllOfClassSource(sourceBS, mask);
+    }
+
+    SInt32 Utf8CountFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        return static_cast<SInt32>(CachedSourceFor(sourceBS).Utf8().Length());
+    }
+
+    bool Utf8IsValidFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        return CachedSourceFor(sourceBS).Utf8().IsValid();
+    }
+
+    BSFixedString Utf8SubstringFunction(StaticFunctionTag* base, BSFixedString sourceBS, SInt32 startIndex, SInt32 count)
+    {
+        // Indexed once per source, so repeated calls in a loop skip the decode
+        CachedSource& source = CachedSourceFor(sourceBS);
+        const std::string& sourceStr = source.Raw();
+        const Utf8Index& index = source.Utf8();
+        const size_t length = index.Length();
+
+        // Same clamping as Substring, counted in characters instead of bytes
+        if (length == 0 || count <= 0)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        const size_t start = startIndex < 0 ? 0 : std::min(static_cast<size_t>(startIndex), length);
+        const size_t end = std::min(start + static_cast<size_t>(count), length);
+
+        const size_t startByte = index.ByteOffset(sourceStr.data(), sourceStr.size(), start);
+        const size_t endByte = index.ByteOffset(sourceStr.data(), sourceStr.size(), end);
+
+        return ToBSFixedString(sourceStr.substr(startByte, endByte - startByte));
+    }
+
+    BSFixedString Utf8CharAtFunction(StaticFunctionTag* base, BSFixedString sourceBS, SInt32 index)
+    {
+        return Utf8SubstringFunction(base, sourceBS, index, 1);
+    }
+
+    BSFixedString Utf8ReverseFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        CachedSource& source = CachedSourceFor(sourceBS);
+        const std::string& sourceStr = source.Raw();
+
+        // Empty string in then empty string out
+        if (sourceStr.empty())
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(Utf8ReverseCopy(sourceStr.data(), sourceStr.size(), source.Utf8()));
     }
 
     BSFixedString JoinFunction(StaticFunctionTag* base, VMArray<BSFixedString> arrayData, BSFixedString delimiterBS)
@@ -1108,6 +1700,67 @@ namespace Papyrus
         return result;
     }
 
+    // Usage: return SpansToVMArray(sourceStr, spans);
+    //
+    inline VMArray<BSFixedString> SpansToVMArray(const std::string& sourceStr, const std::vector<TokenSpan>& spans)
+    {
+        VMArray<BSFixedString> result;
+
+        // One buffer reused for every token, so only the interning allocates
+        std::string token;
+        for (const TokenSpan& span : spans)
+        {
+            token.assign(sourceStr, span.start, span.length);
+            BSFixedString tokenBS = ToBSFixedString(token);
+            result.Push(&tokenBS);
+        }
+
+        return result;
+    }
+
+    VMArray<BSFixedString> SplitAnyFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString delimiterCharsBS, bool dropEmpty)
+    {
+        // Delimiters match exactly, as in Split
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
+        const DelimiterSet delimiters(CachedSourceFor(delimiterCharsBS).Raw());
+
+        std::vector<TokenSpan> spans;
+        SplitAnySpans(sourceStr.data(), sourceStr.length(), delimiters, dropEmpty, spans);
+
+        return SpansToVMArray(sourceStr, spans);
+    }
+
+    VMArray<BSFixedString> SplitWhitespaceFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        const std::string& sourceStr = CachedSourceFor(sourceBS).Raw();
+
+        std::vector<TokenSpan> spans;
+        SplitWhitespaceSpans(sourceStr.data(), sourceStr.length(), spans);
+
+        return SpansToVMArray(sourceStr, spans);
+    }
+
+    SInt32 TokenCountFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString delimiterBS)
+    {
+        // Split(source, delimiter).Length, without building the array
+        return static_cast<SInt32>(CachedSourceFor(sourceBS).Tokens(delimiterBS).size());
+    }
+
+    BSFixedString TokenAtFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString delimiterBS, SInt32 index)
+    {
+        CachedSource& source = CachedSourceFor(sourceBS);
+        const std::vector<TokenSpan>& tokens = source.Tokens(delimiterBS);
+
+        if (index < 0 || static_cast<size_t>(index) >= tokens.size())
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        // Only the requested token is interned
+        const TokenSpan& token = tokens[index];
+        return ToBSFixedString(source.Raw().substr(token.start, token.length));
+    }
+
     BSFixedString OrdinalJoinFunction(StaticFunctionTag* base, VMArray<SInt32> arrayData)
     {
         std::string resultStr;
@@ -1158,6 +1811,100 @@ namespace Papyrus
         return resultArray;
     }
 
+    BSFixedString Base64EncodeFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        const std::string sourceStr = FromBSFixedString(sourceBS);
+        if (sourceStr.length() / 3 * 4 > MAX_OUTPUT_SIZE)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(Base64Encode(sourceStr.data(), sourceStr.length()));
+    }
+
+    BSFixedString Base64DecodeFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        // A zero byte ends the Papyrus string; Base64ToOrdinalArray keeps them
+        const std::string sourceStr = FromBSFixedString(sourceBS);
+        std::string bytes;
+        if (!Base64Decode(sourceStr.data(), sourceStr.length(), bytes))
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(bytes);
+    }
+
+    BSFixedString HexEncodeFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        const std::string sourceStr = FromBSFixedString(sourceBS);
+        if (sourceStr.length() * 2 > MAX_OUTPUT_SIZE)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(HexEncode(sourceStr.data(), sourceStr.length()));
+    }
+
+    BSFixedString HexDecodeFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        const std::string sourceStr = FromBSFixedString(sourceBS);
+        std::string bytes;
+        if (!HexDecode(sourceStr.data(), sourceStr.length(), bytes))
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(bytes);
+    }
+
+    BSFixedString OrdinalArrayToBase64Function(StaticFunctionTag* base, VMArray<SInt32> arrayData)
+    {
+        const UInt32 len = arrayData.Length();
+        std::string bytes;
+        bytes.reserve(len);
+
+        // Same bytes OrdinalJoin would produce, zero included
+        for (UInt32 i = 0; i < len; i++)
+        {
+            SInt32 ordinal = 0;
+            arrayData.Get(&ordinal, i);
+
+            if (IsExtendedASCIIOrdinal(ordinal))
+            {
+                bytes.push_back(static_cast<char>(ordinal));
+            }
+        }
+
+        if (bytes.length() / 3 * 4 > MAX_OUTPUT_SIZE)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(Base64Encode(bytes.data(), bytes.length()));
+    }
+
+    VMArray<SInt32> Base64ToOrdinalArrayFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        VMArray<SInt32> resultArray;
+
+        const std::string sourceStr = FromBSFixedString(sourceBS);
+        std::string bytes;
+        if (!Base64Decode(sourceStr.data(), sourceStr.length(), bytes))
+        {
+            return resultArray;
+        }
+
+        // One element per byte, as OrdinalSplit gives
+        for (unsigned char c : bytes)
+        {
+            SInt32 ordinal = c;
+            resultArray.Push(&ordinal);
+        }
+
+        return resultArray;
+    }
+
     VMArray<BSFixedString> SortFunction(StaticFunctionTag* base, VMArray<BSFixedString> parts)
     {
         // Determine length of input array
@@ -1173,16 +1920,22 @@ namespace Papyrus
         // Temporary vector to hold all elements safely
         std::vector<BSFixedString> tempVec(length);
 
+        // Lowercase keys, folded once per element rather than once per comparison
+        std::vector<std::string> keys(length);
+        std::vector<UInt32> order(length);
+
         // Copy elements from VMArray into vector
         for (UInt32 i = 0; i < length; ++i)
         {
             parts.Get(&tempVec[i], i);
+            keys[i] = ToLowerCopy(FromBSFixedString(tempVec[i]));
+            order[i] = i;
         }
 
-        // Sort the vector using case-insensitive CompareFunction
-        std::sort(tempVec.begin(), tempVec.end(), [](const BSFixedString& a, const BSFixedString& b)
+        // Sort with the same case-insensitive ordering as CompareFunction
+        std::sort(order.begin(), order.end(), [&keys](UInt32 a, UInt32 b)
         {
-            return CompareFunction(nullptr, a, b) < 0;
+            return keys[a].compare(keys[b]) < 0;
         });
 
         // Prepare result VMArray
@@ -1191,156 +1944,1104 @@ namespace Papyrus
         // Push sorted elements into result safely
         for (UInt32 i = 0; i < length; ++i)
         {
-            result.Push(&tempVec[i]);
+            result.Push(&tempVec[order[i]]);
         }
 
         // Return the sorted array
         return result;
     }
 
-    bool RegisterFunctions(VirtualMachine* vm)
+    VMArray<BSFixedString> SortNaturalFunction(StaticFunctionTag* base, VMArray<BSFixedString> parts, bool descending, bool stable)
     {
-        vm->RegisterFunction(new NativeFunction0<StaticFunctionTag, BSFixedString>(PLUGIN_VERSION_FUNCTION_NAME, PAPYRUS_CLASS_NAME, PluginVersionFunction, vm));
-        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, PLUGIN_VERSION_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+        std::vector<BSFixedString> items;
+        const std::vector<UInt32> order = SortedOrder(parts, items, true, descending, stable);
 
-        vm->RegisterFunction(new NativeFunction0<StaticFunctionTag, BSFixedString>(GAME_VERSION_FUNCTION_NAME, PAPYRUS_CLASS_NAME, GameVersionFunction, vm));
-        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, GAME_VERSION_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+        VMArray<BSFixedString> result;
+        for (UInt32 index : order)
+        {
+            result.Push(&items[index]);
+        }
 
-        vm->RegisterFunction(new NativeFunction0<StaticFunctionTag, BSFixedString>(RUNTIME_VERSION_FUNCTION_NAME, PAPYRUS_CLASS_NAME, RuntimeVersionFunction, vm));
-        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, RUNTIME_VERSION_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+        return result;
+    }
 
-        vm->RegisterFunction(new NativeFunction0<StaticFunctionTag, BSFixedString>(VERSION_INFO_FUNCTION_NAME, PAPYRUS_CLASS_NAME, VersionInfoFunction, vm));
-        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, VERSION_INFO_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+    VMArray<SInt32> SortIndicesFunction(StaticFunctionTag* base, VMArray<BSFixedString> parts, bool descending, bool stable)
+    {
+        // Positions rather than strings, so parallel arrays can be reordered to match
+        std::vector<BSFixedString> items;
+        const std::vector<UInt32> order = SortedOrder(parts, items, false, descending, stable);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(ECHO_FUNCTION_NAME, PAPYRUS_CLASS_NAME, EchoFunction, vm));
-        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ECHO_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+        VMArray<SInt32> result;
+        for (UInt32 index : order)
+        {
+            SInt32 value = static_cast<SInt32>(index);
+            result.Push(&value);
+        }
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, BSFixedString>(COUNT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, CountFunction, vm));
-        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, COUNT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+        return result;
+    }
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_EMPTY_FUNCTION_NAME, PAPYRUS_CLASS_NAME, IsEmptyFunction, vm));
-        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_EMPTY_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+    VMArray<SInt32> SortNaturalIndicesFunction(StaticFunctionTag* base, VMArray<BSFixedString> parts, bool descending, bool stable)
+    {
+        std::vector<BSFixedString> items;
+        const std::vector<UInt32> order = SortedOrder(parts, items, true, descending, stable);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, BSFixedString, BSFixedString>(COMPARE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, CompareFunction, vm));
-        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, COMPARE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+        VMArray<SInt32> result;
+        for (UInt32 index : order)
+        {
+            SInt32 value = static_cast<SInt32>(index);
+            result.Push(&value);
+        }
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, bool, BSFixedString, BSFixedString>(EQUALS_FUNCTION_NAME, PAPYRUS_CLASS_NAME, EqualsFunction, vm));
+        return result;
+    }
+
+    VMArray<BSFixedString> DistinctFunction(StaticFunctionTag* base, VMArray<BSFixedString> parts)
+    {
+        std::vector<BSFixedString> elements = ElementsOf(parts);
+        FoldedStringSet seen(elements.size());
+        VMArray<BSFixedString> result;
+
+        // First occurrence wins, keeping its own casing
+        for (BSFixedString& element : elements)
+        {
+            if (seen.Insert(ElementText(element), element.data))
+            {
+                result.Push(&element);
+            }
+        }
+
+        return result;
+    }
+
+    VMArray<BSFixedString> UnionFunction(StaticFunctionTag* base, VMArray<BSFixedString> first, VMArray<BSFixedString> second)
+    {
+        std::vector<BSFixedString> firstElements = ElementsOf(first);
+        std::vector<BSFixedString> secondElements = ElementsOf(second);
+        FoldedStringSet seen(firstElements.size() + secondElements.size());
+        VMArray<BSFixedString> result;
+
+        for (std::vector<BSFixedString>* elements : { &firstElements, &secondElements })
+        {
+            for (BSFixedString& element : *elements)
+            {
+                if (seen.Insert(ElementText(element), element.data))
+                {
+                    result.Push(&element);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    // Distinct elements of first that are (or, with keep false, are not) in second
+    //
+    inline VMArray<BSFixedString> FilterBySet(VMArray<BSFixedString>& first, VMArray<BSFixedString>& second, bool keep)
+    {
+        std::vector<BSFixedString> firstElements = ElementsOf(first);
+        const std::vector<BSFixedString> secondElements = ElementsOf(second);
+
+        FoldedStringSet other(secondElements.size());
+        for (const BSFixedString& element : secondElements)
+        {
+            other.Insert(ElementText(element), element.data);
+        }
+
+        FoldedStringSet seen(firstElements.size());
+        VMArray<BSFixedString> result;
+
+        for (BSFixedString& element : firstElements)
+        {
+            if (other.Contains(ElementText(element), element.data) == keep && seen.Insert(ElementText(element), element.data))
+            {
+                result.Push(&element);
+            }
+        }
+
+        return result;
+    }
+
+    VMArray<BSFixedString> IntersectFunction(StaticFunctionTag* base, VMArray<BSFixedString> first, VMArray<BSFixedString> second)
+    {
+        return FilterBySet(first, second, true);
+    }
+
+    VMArray<BSFixedString> DifferenceFunction(StaticFunctionTag* base, VMArray<BSFixedString> first, VMArray<BSFixedString> second)
+    {
+        return FilterBySet(first, second, false);
+    }
+
+    SInt32 CountDistinctFunction(StaticFunctionTag* base, VMArray<BSFixedString> parts)
+    {
+        const std::vector<BSFixedString> elements = ElementsOf(parts);
+        FoldedStringSet seen(elements.size());
+
+        for (const BSFixedString& element : elements)
+        {
+            seen.Insert(ElementText(element), element.data);
+        }
+
+        return static_cast<SInt32>(seen.Count());
+    }
+
+    SInt32 BinarySearchFunction(StaticFunctionTag* base, VMArray<BSFixedString> sorted, BSFixedString keyBS)
+    {
+        return SortedFind(sorted, keyBS);
+    }
+
+    VMArray<SInt32> BinarySearchManyFunction(StaticFunctionTag* base, VMArray<BSFixedString> sorted, VMArray<BSFixedString> keys)
+    {
+        VMArray<SInt32> result;
+        const UInt32 len = keys.Length();
+
+        for (UInt32 i = 0; i < len; i++)
+        {
+            BSFixedString key;
+            keys.Get(&key, i);
+
+            SInt32 index = SortedFind(sorted, key);
+            result.Push(&index);
+        }
+
+        return result;
+    }
+
+    SInt32 LowerBoundFunction(StaticFunctionTag* base, VMArray<BSFixedString> sorted, BSFixedString keyBS)
+    {
+        return static_cast<SInt32>(SortedBound<false>(sorted, keyBS));
+    }
+
+    SInt32 UpperBoundFunction(StaticFunctionTag* base, VMArray<BSFixedString> sorted, BSFixedString keyBS)
+    {
+        return static_cast<SInt32>(SortedBound<true>(sorted, keyBS));
+    }
+
+    VMArray<SInt32> EqualRangeFunction(StaticFunctionTag* base, VMArray<BSFixedString> sorted, BSFixedString keyBS)
+    {
+        // [first, last): last - first elements equal the key
+        SInt32 bounds[2] = { static_cast<SInt32>(SortedBound<false>(sorted, keyBS)), static_cast<SInt32>(SortedBound<true>(sorted, keyBS)) };
+
+        VMArray<SInt32> result;
+        result.Push(&bounds[0]);
+        result.Push(&bounds[1]);
+        return result;
+    }
+
+    SInt32 TextIndexBuildFunction(StaticFunctionTag* base, VMArray<BSFixedString> entries)
+    {
+        // Tokenize every entry once; later queries never look at the text again
+        return g_textIndexes.Add(std::make_shared<TextIndex>(FromVMArray(entries)));
+    }
+
+    VMArray<SInt32> TextIndexQueryFunction(StaticFunctionTag* base, SInt32 handle, BSFixedString queryBS)
+    {
+        VMArray<SInt32> result;
+
+        // Unknown or closed handle -> empty array
+        std::shared_ptr<TextIndex> index = g_textIndexes.Get(handle);
+        if (!index)
+        {
+            return result;
+        }
+
+        // Matching entry indexes come back in ascending order
+        for (UInt32 entry : index->Query(FromBSFixedString(queryBS)))
+        {
+            SInt32 value = static_cast<SInt32>(entry);
+            result.Push(&value);
+        }
+
+        return result;
+    }
+
+    bool TextIndexCloseFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        return g_textIndexes.Remove(handle);
+    }
+
+    SInt32 CursorOpenFunction(StaticFunctionTag* base, BSFixedString sourceBS)
+    {
+        // The one copy of the text every later cursor call reads from
+        return g_cursors.Add(std::make_shared<TextCursor>(FromBSFixedString(sourceBS)));
+    }
+
+    BSFixedString CursorNextFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        // Unknown or closed handle -> empty string, same as the end of the text
+        std::shared_ptr<TextCursor> cursor = g_cursors.Get(handle);
+        if (!cursor)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(cursor->Next());
+    }
+
+    SInt32 CursorPeekOrdinalFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        std::shared_ptr<TextCursor> cursor = g_cursors.Get(handle);
+        if (!cursor)
+        {
+            return NOT_FOUND;
+        }
+
+        return cursor->PeekOrdinal();
+    }
+
+    SInt32 CursorSkipWhileFunction(StaticFunctionTag* base, SInt32 handle, SInt32 classMask)
+    {
+        std::shared_ptr<TextCursor> cursor = g_cursors.Get(handle);
+        if (!cursor)
+        {
+            return 0;
+        }
+
+        // Same class bits as IsAllOfClass
+        return cursor->SkipWhile(static_cast<UInt16>(classMask & kCharClass_All));
+    }
+
+    BSFixedString CursorTakeUntilFunction(StaticFunctionTag* base, SInt32 handle, BSFixedString delimiterBS)
+    {
+        std::shared_ptr<TextCursor> cursor = g_cursors.Get(handle);
+        if (!cursor)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(cursor->TakeUntil(FromBSFixedString(delimiterBS)));
+    }
+
+    bool CursorCloseFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        return g_cursors.Remove(handle);
+    }
+
+    SInt32 DocCreateFunction(StaticFunctionTag* base, BSFixedString textBS)
+    {
+        return g_documents.Add(std::make_shared<TextDocument>(FromBSFixedString(textBS)));
+    }
+
+    SInt32 DocLengthFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        std::shared_ptr<TextDocument> document = g_documents.Get(handle);
+        return document ? static_cast<SInt32>(document->Length()) : 0;
+    }
+
+    bool DocInsertFunction(StaticFunctionTag* base, SInt32 handle, SInt32 position, BSFixedString textBS)
+    {
+        // Negative positions clamp to the start, as in ReplaceIndex
+        std::shared_ptr<TextDocument> document = g_documents.Get(handle);
+        return document && document->Insert(static_cast<size_t>(std::max<SInt32>(position, 0)), FromBSFixedString(textBS));
+    }
+
+    bool DocDeleteFunction(StaticFunctionTag* base, SInt32 handle, SInt32 position, SInt32 count)
+    {
+        std::shared_ptr<TextDocument> document = g_documents.Get(handle);
+        if (!document)
+        {
+            return false;
+        }
+
+        document->Delete(static_cast<size_t>(std::max<SInt32>(position, 0)), static_cast<size_t>(std::max<SInt32>(count, 0)));
+        return true;
+    }
+
+    bool DocReplaceFunction(StaticFunctionTag* base, SInt32 handle, SInt32 position, SInt32 count, BSFixedString textBS)
+    {
+        std::shared_ptr<TextDocument> document = g_documents.Get(handle);
+        return document && document->Replace(static_cast<size_t>(std::max<SInt32>(position, 0)), static_cast<size_t>(std::max<SInt32>(count, 0)), FromBSFixedString(textBS));
+    }
+
+    BSFixedString DocSubstringFunction(StaticFunctionTag* base, SInt32 handle, SInt32 position, SInt32 count)
+    {
+        std::shared_ptr<TextDocument> document = g_documents.Get(handle);
+        if (!document || count <= 0)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(document->Substring(static_cast<size_t>(std::max<SInt32>(position, 0)), static_cast<size_t>(count)));
+    }
+
+    SInt32 DocSearchFunction(StaticFunctionTag* base, SInt32 handle, BSFixedString needleBS, SInt32 startIndex)
+    {
+        std::shared_ptr<TextDocument> document = g_documents.Get(handle);
+        if (!document || startIndex < 0)
+        {
+            return NOT_FOUND;
+        }
+
+        return document->Search(CachedSourceFor(needleBS).Folded(), static_cast<size_t>(startIndex));
+    }
+
+    BSFixedString DocToStringFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        // The only point where the document's text becomes a Papyrus string
+        std::shared_ptr<TextDocument> document = g_documents.Get(handle);
+        return ToBSFixedString(document ? document->ToString() : EMPTY_STRING);
+    }
+
+    bool DocCloseFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        return g_documents.Remove(handle);
+    }
+
+    SInt32 SortAsyncFunction(StaticFunctionTag* base, VMArray<BSFixedString> parts, SInt32 budgetMilliseconds)
+    {
+        // Copy the elements now; the worker never touches the VM array
+        std::vector<std::string> items = FromVMArray(parts);
+
+        return SubmitAsyncJob(std::make_shared<Async::Job>([items = std::move(items)](Async::Job& job) mutable
+        {
+            const size_t length = items.size();
+            std::vector<std::string> keys(length);
+            std::vector<UInt32> order(length);
+
+            for (size_t i = 0; i < length; i++)
+            {
+                keys[i] = ToLowerCopy(items[i]);
+                order[i] = static_cast<UInt32>(i);
+            }
+
+            // Same ordering as Sort; equal keys keep their input order
+            if (!StableSortByKeys(keys, order, [&job] { return job.ShouldStop(); }))
+            {
+                return false;
+            }
+
+            std::vector<std::string>& result = job.Parts();
+            result.reserve(length);
+
+            for (UInt32 index : order)
+            {
+                result.push_back(std::move(items[index]));
+            }
+
+            return true;
+        }, budgetMilliseconds));
+    }
+
+    SInt32 ReplaceAllAsyncFunction(StaticFunctionTag* base, BSFixedString sourceBS, BSFixedString needleBS, BSFixedString replacementBS, SInt32 budgetMilliseconds)
+    {
+        // Folding the source is left to the worker; only the copies are made here
+        std::string sourceStr = FromBSFixedString(sourceBS);
+        std::string needleStr = CachedSourceFor(needleBS).Folded();
+        std::string replacementStr = FromBSFixedString(replacementBS);
+
+        return SubmitAsyncJob(std::make_shared<Async::Job>([sourceStr = std::move(sourceStr), needleStr = std::move(needleStr), replacementStr = std::move(replacementStr)](Async::Job& job)
+        {
+            // Nothing to replace: the result is the source, as with ReplaceAll
+            if (sourceStr.empty() || needleStr.empty())
+            {
+                job.Text() = sourceStr;
+                return true;
+            }
+
+            return ReplaceAllCopy(sourceStr, ToLowerCopy(sourceStr), needleStr, replacementStr, job.Text(), [&job] { return job.ShouldStop(); });
+        }, budgetMilliseconds));
+    }
+
+    SInt32 AsyncStatusFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        std::shared_ptr<Async::Job> job = g_asyncJobs.Get(handle);
+        return job ? job->Status() : NOT_FOUND;
+    }
+
+    bool AsyncIsDoneFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        // Unknown handles count as done so a polling loop always ends
+        std::shared_ptr<Async::Job> job = g_asyncJobs.Get(handle);
+        return !job || job->Status() != Async::kJob_Pending;
+    }
+
+    BSFixedString AsyncResultFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        // Empty until the job has finished without being stopped
+        std::shared_ptr<Async::Job> job = g_asyncJobs.Get(handle);
+        if (!job || job->Status() != Async::kJob_Done)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(job->Text());
+    }
+
+    VMArray<BSFixedString> AsyncResultArrayFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        std::shared_ptr<Async::Job> job = g_asyncJobs.Get(handle);
+        if (!job || job->Status() != Async::kJob_Done)
+        {
+            return VMArray<BSFixedString>();
+        }
+
+        return ToVMArray(job->Parts());
+    }
+
+    bool AsyncCancelFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        // The worker notices at its next check; false if there is nothing left to stop
+        std::shared_ptr<Async::Job> job = g_asyncJobs.Get(handle);
+        if (!job || job->Status() != Async::kJob_Pending)
+        {
+            return false;
+        }
+
+        job->Cancel();
+        return true;
+    }
+
+    bool AsyncCloseFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        // A job still running is stopped rather than finished for nobody
+        std::shared_ptr<Async::Job> job = g_asyncJobs.Get(handle);
+        if (job)
+        {
+            job->Cancel();
+        }
+
+        return g_asyncJobs.Remove(handle);
+    }
+
+    BSFixedString ReadTextFileFunction(StaticFunctionTag* base, BSFixedString pathBS)
+    {
+        // Missing, refused and oversized files all read as empty
+        std::shared_ptr<MappedTextFile> file = OpenDataTextFile(FromBSFixedString(pathBS));
+        if (!file || file->Length() > MAX_OUTPUT_SIZE)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(std::string(file->Text(), file->Length()));
+    }
+
+    VMArray<BSFixedString> ReadLinesFunction(StaticFunctionTag* base, BSFixedString pathBS)
+    {
+        std::shared_ptr<MappedTextFile> file = OpenDataTextFile(FromBSFixedString(pathBS));
+        if (!file)
+        {
+            return VMArray<BSFixedString>();
+        }
+
+        return ToVMArray(file->Lines());
+    }
+
+    BSFixedString ReadLineFunction(StaticFunctionTag* base, BSFixedString pathBS, SInt32 index)
+    {
+        // The line index is kept with the cached mapping, so reading line by line stays cheap
+        std::shared_ptr<MappedTextFile> file = OpenDataTextFile(FromBSFixedString(pathBS));
+        if (!file || index < 0)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(file->Line(static_cast<size_t>(index)));
+    }
+
+    SInt32 JsonParseFunction(StaticFunctionTag* base, BSFixedString textBS)
+    {
+        // Invalid JSON gets no handle
+        std::shared_ptr<JsonDocument> document = ParseJson(FromBSFixedString(textBS));
+        return document ? g_jsonDocuments.Add(document) : INVALID_HANDLE;
+    }
+
+    SInt32 JsonParseFileFunction(StaticFunctionTag* base, BSFixedString pathBS)
+    {
+        std::shared_ptr<MappedTextFile> file = OpenDataTextFile(FromBSFixedString(pathBS));
+        if (!file)
+        {
+            return INVALID_HANDLE;
+        }
+
+        std::shared_ptr<JsonDocument> document = ParseJson(std::string(file->Text(), file->Length()));
+        return document ? g_jsonDocuments.Add(document) : INVALID_HANDLE;
+    }
+
+    SInt32 JsonGetTypeFunction(StaticFunctionTag* base, SInt32 handle, BSFixedString pathBS)
+    {
+        std::shared_ptr<JsonDocument> document = g_jsonDocuments.Get(handle);
+        const UInt32 node = document ? document->Find(FromBSFixedString(pathBS)) : JSON_NO_NODE;
+
+        return node != JSON_NO_NODE ? document->Type(node) : NOT_FOUND;
+    }
+
+    BSFixedString JsonGetStringFunction(StaticFunctionTag* base, SInt32 handle, BSFixedString pathBS, BSFixedString defaultBS)
+    {
+        // Missing values, null and values too large for a string all fall back to the default
+        std::shared_ptr<JsonDocument> document = g_jsonDocuments.Get(handle);
+        const UInt32 node = document ? document->Find(FromBSFixedString(pathBS)) : JSON_NO_NODE;
+        if (node == JSON_NO_NODE || document->Type(node) == kJson_Null || document->ByteLength(node) > MAX_OUTPUT_SIZE)
+        {
+            return defaultBS;
+        }
+
+        return ToBSFixedString(document->AsString(node));
+    }
+
+    SInt32 JsonGetIntFunction(StaticFunctionTag* base, SInt32 handle, BSFixedString pathBS, SInt32 defaultValue)
+    {
+        std::shared_ptr<JsonDocument> document = g_jsonDocuments.Get(handle);
+        const UInt32 node = document ? document->Find(FromBSFixedString(pathBS)) : JSON_NO_NODE;
+
+        double value = 0.0;
+        if (node == JSON_NO_NODE || !document->AsNumber(node, value))
+        {
+            return defaultValue;
+        }
+
+        // Truncate toward zero, clamped to the Papyrus Int range
+        if (value >= 2147483647.0)
+        {
+            return 2147483647;
+        }
+        if (value <= -2147483648.0)
+        {
+            return static_cast<SInt32>(-2147483647 - 1);
+        }
+        return static_cast<SInt32>(value);
+    }
+
+    float JsonGetFloatFunction(StaticFunctionTag* base, SInt32 handle, BSFixedString pathBS, float defaultValue)
+    {
+        std::shared_ptr<JsonDocument> document = g_jsonDocuments.Get(handle);
+        const UInt32 node = document ? document->Find(FromBSFixedString(pathBS)) : JSON_NO_NODE;
+
+        double value = 0.0;
+        if (node == JSON_NO_NODE || !document->AsNumber(node, value))
+        {
+            return defaultValue;
+        }
+
+        return static_cast<float>(value);
+    }
+
+    VMArray<BSFixedString> JsonGetArrayFunction(StaticFunctionTag* base, SInt32 handle, BSFixedString pathBS)
+    {
+        std::shared_ptr<JsonDocument> document = g_jsonDocuments.Get(handle);
+        const UInt32 node = document ? document->Find(FromBSFixedString(pathBS)) : JSON_NO_NODE;
+        if (node == JSON_NO_NODE)
+        {
+            return VMArray<BSFixedString>();
+        }
+
+        // Elements over the string size limit are left out, as ReadTextFile would refuse them
+        return ToVMArray(document->Elements(node, MAX_OUTPUT_SIZE));
+    }
+
+    bool JsonCloseFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        return g_jsonDocuments.Remove(handle);
+    }
+
+    SInt32 IniLoadFunction(StaticFunctionTag* base, BSFixedString pathBS)
+    {
+        // An unchanged file shares the table parsed by an earlier IniLoad
+        std::shared_ptr<IniFile> ini = LoadDataIniFile(FromBSFixedString(pathBS));
+        return ini ? g_iniFiles.Add(ini) : INVALID_HANDLE;
+    }
+
+    BSFixedString IniGetFunction(StaticFunctionTag* base, SInt32 handle, BSFixedString sectionBS, BSFixedString keyBS, BSFixedString defaultBS)
+    {
+        std::shared_ptr<IniFile> ini = g_iniFiles.Get(handle);
+        const std::string* value = ini ? ini->Find(FromBSFixedString(sectionBS), FromBSFixedString(keyBS)) : nullptr;
+
+        return value ? ToBSFixedString(*value) : defaultBS;
+    }
+
+    bool IniCloseFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        return g_iniFiles.Remove(handle);
+    }
+
+    SInt32 StringsTableOpenFunction(StaticFunctionTag* base, BSFixedString pathBS)
+    {
+        std::shared_ptr<StringsTable> table = OpenDataStringsTable(FromBSFixedString(pathBS));
+        return table ? g_stringsTables.Add(table) : INVALID_HANDLE;
+    }
+
+    BSFixedString StringsTableGetFunction(StaticFunctionTag* base, SInt32 handle, SInt32 id)
+    {
+        // IDs are unsigned in the file; Papyrus passes the same 32 bits as a signed Int
+        std::shared_ptr<StringsTable> table = g_stringsTables.Get(handle);
+        std::string value;
+        if (!table || !table->Get(static_cast<UInt32>(id), value) || value.length() > MAX_OUTPUT_SIZE)
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+
+        return ToBSFixedString(value);
+    }
+
+    VMArray<BSFixedString> StringsTableGetManyFunction(StaticFunctionTag* base, SInt32 handle, VMArray<SInt32> ids)
+    {
+        // One handle lookup for the whole batch; missing IDs keep their slot as ""
+        std::shared_ptr<StringsTable> table = g_stringsTables.Get(handle);
+        const UInt32 len = ids.Length();
+        std::vector<std::string> values(table ? len : 0);
+
+        for (UInt32 i = 0; i < values.size(); i++)
+        {
+            SInt32 id = 0;
+            ids.Get(&id, i);
+
+            if (!table->Get(static_cast<UInt32>(id), values[i]) || values[i].length() > MAX_OUTPUT_SIZE)
+            {
+                values[i].clear();
+            }
+        }
+
+        return ToVMArray(values);
+    }
+
+    bool StringsTableCloseFunction(StaticFunctionTag* base, SInt32 handle)
+    {
+        return g_stringsTables.Remove(handle);
+    }
+
+    BSFixedString GetStatsFunction(StaticFunctionTag* base)
+    {
+        // Empty unless bEnabled=1 under [Stats] in the plugin INI
+        if (!(g_instrumentFlags.load() & kInstrument_Stats))
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+        return ToBSFixedString(Stats::Report());
+    }
+
+    void ResetStatsFunction(StaticFunctionTag* base)
+    {
+        Stats::Reset();
+    }
+
+    BSFixedString TraceFlushFunction(StaticFunctionTag* base)
+    {
+        // Empty unless bEnabled=1 under [Trace] in the plugin INI
+        const std::string path = LogSiblingPath(".trace.json");
+        if (path.empty() || !Trace::Flush(path))
+        {
+            return ToBSFixedString(EMPTY_STRING);
+        }
+        return ToBSFixedString(path);
+    }
+
+    void CloseAllHandles()
+    {
+        g_textIndexes.Clear();
+        g_cursors.Clear();
+        g_documents.Clear();
+        g_jsonDocuments.Clear();
+        g_iniFiles.Clear();
+        g_stringsTables.Clear();
+
+        // Running jobs are stopped, and their completion events dropped
+        g_asyncJobs.Clear([](Async::Job& job) { job.Cancel(); });
+        Async::EndSession();
+    }
+
+    bool RegisterFunctions(VirtualMachine* vm)
+    {
+        // Decide whether natives are timed before any of them are registered
+        LoadInstrumentConfig();
+
+        vm->RegisterFunction(new NativeFunction0<StaticFunctionTag, BSFixedString>(PLUGIN_VERSION_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(PLUGIN_VERSION_FUNCTION_NAME, PluginVersionFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, PLUGIN_VERSION_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction0<StaticFunctionTag, BSFixedString>(GAME_VERSION_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(GAME_VERSION_FUNCTION_NAME, GameVersionFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, GAME_VERSION_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction0<StaticFunctionTag, BSFixedString>(RUNTIME_VERSION_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(RUNTIME_VERSION_FUNCTION_NAME, RuntimeVersionFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, RUNTIME_VERSION_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction0<StaticFunctionTag, BSFixedString>(VERSION_INFO_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(VERSION_INFO_FUNCTION_NAME, VersionInfoFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, VERSION_INFO_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(ECHO_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ECHO_FUNCTION_NAME, EchoFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ECHO_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, BSFixedString>(COUNT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(COUNT_FUNCTION_NAME, CountFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, COUNT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_EMPTY_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_EMPTY_FUNCTION_NAME, IsEmptyFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_EMPTY_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, BSFixedString, BSFixedString>(COMPARE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(COMPARE_FUNCTION_NAME, CompareFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, COMPARE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, bool, BSFixedString, BSFixedString>(EQUALS_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(EQUALS_FUNCTION_NAME, EqualsFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, EQUALS_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, BSFixedString, BSFixedString>(SEARCH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, SearchFunction, vm));
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, BSFixedString, BSFixedString>(SEARCH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SEARCH_FUNCTION_NAME, SearchFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SEARCH_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, BSFixedString, BSFixedString>(SEARCH_REVERSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, SearchReverseFunction, vm));
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, BSFixedString, BSFixedString>(SEARCH_REVERSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SEARCH_REVERSE_FUNCTION_NAME, SearchReverseFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SEARCH_REVERSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, SInt32, BSFixedString, BSFixedString, SInt32>(SEARCH_INDEX_FUNCTION_NAME, PAPYRUS_CLASS_NAME, SearchIndexFunction, vm));
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, SInt32, BSFixedString, BSFixedString, SInt32>(SEARCH_INDEX_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SEARCH_INDEX_FUNCTION_NAME, SearchIndexFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SEARCH_INDEX_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, SInt32, BSFixedString, BSFixedString, SInt32>(SEARCH_INDEX_REVERSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, SearchIndexReverseFunction, vm));
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, SInt32, BSFixedString, BSFixedString, SInt32>(SEARCH_INDEX_REVERSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SEARCH_INDEX_REVERSE_FUNCTION_NAME, SearchIndexReverseFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SEARCH_INDEX_REVERSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, bool, BSFixedString, BSFixedString>(CONTAINS_FUNCTION_NAME, PAPYRUS_CLASS_NAME, ContainsFunction, vm));
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, VMArray<SInt32>, BSFixedString, BSFixedString, bool>(FIND_ALL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(FIND_ALL_FUNCTION_NAME, FindAllFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, FIND_ALL_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, SInt32, BSFixedString, BSFixedString, bool>(COUNT_OCCURRENCES_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(COUNT_OCCURRENCES_FUNCTION_NAME, CountOccurrencesFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, COUNT_OCCURRENCES_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, BSFixedString, SInt32>(COUNT_CHAR_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(COUNT_CHAR_FUNCTION_NAME, CountCharFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, COUNT_CHAR_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, bool, BSFixedString, BSFixedString>(CONTAINS_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(CONTAINS_FUNCTION_NAME, ContainsFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, CONTAINS_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, bool, BSFixedString, BSFixedString>(STARTS_WITH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, StartsWithFunction, vm));
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, bool, BSFixedString, BSFixedString>(STARTS_WITH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(STARTS_WITH_FUNCTION_NAME, StartsWithFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, STARTS_WITH_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, bool, BSFixedString, BSFixedString>(ENDS_WITH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, EndsWithFunction, vm));
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, bool, BSFixedString, BSFixedString>(ENDS_WITH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ENDS_WITH_FUNCTION_NAME, EndsWithFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ENDS_WITH_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, BSFixedString, BSFixedString, BSFixedString>(REPLACE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, ReplaceFunction, vm));
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, BSFixedString, BSFixedString, BSFixedString>(REPLACE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(REPLACE_FUNCTION_NAME, ReplaceFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, REPLACE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, BSFixedString, BSFixedString, BSFixedString>(REPLACE_ALL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, ReplaceAllFunction, vm));
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, BSFixedString, BSFixedString, BSFixedString>(REPLACE_ALL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(REPLACE_ALL_FUNCTION_NAME, ReplaceAllFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, REPLACE_ALL_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, BSFixedString, SInt32, SInt32>(SUBSTRING_FUNCTION_NAME, PAPYRUS_CLASS_NAME, SubstringFunction, vm));
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, BSFixedString, SInt32, SInt32>(SUBSTRING_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SUBSTRING_FUNCTION_NAME, SubstringFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SUBSTRING_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction4<StaticFunctionTag, BSFixedString, BSFixedString, SInt32, SInt32, BSFixedString>(REPLACE_INDEX_FUNCTION_NAME, PAPYRUS_CLASS_NAME, ReplaceIndexFunction, vm));
+        vm->RegisterFunction(new NativeFunction4<StaticFunctionTag, BSFixedString, BSFixedString, SInt32, SInt32, BSFixedString>(REPLACE_INDEX_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(REPLACE_INDEX_FUNCTION_NAME, ReplaceIndexFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, REPLACE_INDEX_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, BSFixedString, SInt32>(CHAR_AT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, CharAtFunction, vm));
+        vm->RegisterFunction(new NativeFunction4<StaticFunctionTag, BSFixedString, BSFixedString, VMArray<SInt32>, VMArray<SInt32>, VMArray<BSFixedString>>(APPLY_EDITS_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(APPLY_EDITS_FUNCTION_NAME, ApplyEditsFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, APPLY_EDITS_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, BSFixedString, SInt32>(CHAR_AT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(CHAR_AT_FUNCTION_NAME, CharAtFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, CHAR_AT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, BSFixedString, SInt32>(ORDINAL_AT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, OrdinalAtFunction, vm));
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, BSFixedString, SInt32>(ORDINAL_AT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ORDINAL_AT_FUNCTION_NAME, OrdinalAtFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ORDINAL_AT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, BSFixedString, BSFixedString>(REMOVE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, RemoveFunction, vm));
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, BSFixedString, BSFixedString>(REMOVE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(REMOVE_FUNCTION_NAME, RemoveFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, REMOVE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, BSFixedString, BSFixedString>(REMOVE_ALL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, RemoveAllFunction, vm));
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, BSFixedString, BSFixedString>(REMOVE_ALL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(REMOVE_ALL_FUNCTION_NAME, RemoveAllFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, REMOVE_ALL_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(REVERSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, ReverseFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(REVERSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(REVERSE_FUNCTION_NAME, ReverseFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, REVERSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, BSFixedString, SInt32>(REPEAT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, RepeatFunction, vm));
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, BSFixedString, SInt32>(REPEAT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(REPEAT_FUNCTION_NAME, RepeatFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, REPEAT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, SInt32>(TO_CHAR_FUNCTION_NAME, PAPYRUS_CLASS_NAME, ToCharFunction, vm));
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, BSFixedString, SInt32, BSFixedString>(PAD_LEFT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(PAD_LEFT_FUNCTION_NAME, PadLeftFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, PAD_LEFT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, BSFixedString, SInt32, BSFixedString>(PAD_RIGHT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(PAD_RIGHT_FUNCTION_NAME, PadRightFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, PAD_RIGHT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, BSFixedString, SInt32, BSFixedString>(CENTER_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(CENTER_FUNCTION_NAME, CenterFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, CENTER_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, SInt32>(TO_CHAR_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TO_CHAR_FUNCTION_NAME, ToCharFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TO_CHAR_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(TO_TITLE_CASE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, ToTitleCaseFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(TO_TITLE_CASE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TO_TITLE_CASE_FUNCTION_NAME, ToTitleCaseFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TO_TITLE_CASE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, BSFixedString>(TO_ORDINAL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, ToOrdinalFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, BSFixedString>(TO_ORDINAL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TO_ORDINAL_FUNCTION_NAME, ToOrdinalFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TO_ORDINAL_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(TRIM_START_FUNCTION_NAME, PAPYRUS_CLASS_NAME, TrimStartFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(TRIM_START_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TRIM_START_FUNCTION_NAME, TrimStartFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TRIM_START_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(TRIM_END_FUNCTION_NAME, PAPYRUS_CLASS_NAME, TrimEndFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(TRIM_END_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TRIM_END_FUNCTION_NAME, TrimEndFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TRIM_END_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(TRIM_BOTH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, TrimBothFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(TRIM_BOTH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TRIM_BOTH_FUNCTION_NAME, TrimBothFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TRIM_BOTH_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_ALPHA_FUNCTION_NAME, PAPYRUS_CLASS_NAME, IsAlphaFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(COLLAPSE_WHITESPACE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(COLLAPSE_WHITESPACE_FUNCTION_NAME, CollapseWhitespaceFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, COLLAPSE_WHITESPACE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(STRIP_CONTROL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(STRIP_CONTROL_FUNCTION_NAME, StripControlFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, STRIP_CONTROL_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, BSFixedString, BSFixedString>(TRANSFORM_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TRANSFORM_FUNCTION_NAME, TransformFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TRANSFORM_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_ALPHA_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_ALPHA_FUNCTION_NAME, IsAlphaFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_ALPHA_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_DIGIT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, IsDigitFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_DIGIT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_DIGIT_FUNCTION_NAME, IsDigitFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_DIGIT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_HEX_FUNCTION_NAME, PAPYRUS_CLASS_NAME, IsHexFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_HEX_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_HEX_FUNCTION_NAME, IsHexFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_HEX_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_ALPHA_NUMERIC_FUNCTION_NAME, PAPYRUS_CLASS_NAME, IsAlphaNumericFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_ALPHA_NUMERIC_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_ALPHA_NUMERIC_FUNCTION_NAME, IsAlphaNumericFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_ALPHA_NUMERIC_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_WHITESPACE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, IsWhitespaceFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_WHITESPACE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_WHITESPACE_FUNCTION_NAME, IsWhitespaceFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_WHITESPACE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_PUNCTUATION_FUNCTION_NAME, PAPYRUS_CLASS_NAME, IsPunctuationFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_PUNCTUATION_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_PUNCTUATION_FUNCTION_NAME, IsPunctuationFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_PUNCTUATION_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_ASCII_FUNCTION_NAME, PAPYRUS_CLASS_NAME, IsASCIIFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_ASCII_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_ASCII_FUNCTION_NAME, IsASCIIFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_ASCII_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_CONTROL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, IsControlFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_CONTROL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_CONTROL_FUNCTION_NAME, IsControlFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_CONTROL_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_PRINTABLE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, IsPrintableFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_PRINTABLE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_PRINTABLE_FUNCTION_NAME, IsPrintableFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_PRINTABLE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_GRAPH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, IsGraphFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(IS_GRAPH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_GRAPH_FUNCTION_NAME, IsGraphFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_GRAPH_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, VMArray<BSFixedString>, BSFixedString>(JOIN_FUNCTION_NAME, PAPYRUS_CLASS_NAME, JoinFunction, vm));
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, bool, BSFixedString, SInt32>(IS_ALL_OF_CLASS_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(IS_ALL_OF_CLASS_FUNCTION_NAME, IsAllOfClassFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, IS_ALL_OF_CLASS_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, BSFixedString>(UTF8_COUNT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(UTF8_COUNT_FUNCTION_NAME, Utf8CountFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, UTF8_COUNT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, BSFixedString>(UTF8_IS_VALID_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(UTF8_IS_VALID_FUNCTION_NAME, Utf8IsValidFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, UTF8_IS_VALID_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, BSFixedString, SInt32>(UTF8_CHAR_AT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(UTF8_CHAR_AT_FUNCTION_NAME, Utf8CharAtFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, UTF8_CHAR_AT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, BSFixedString, SInt32, SInt32>(UTF8_SUBSTRING_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(UTF8_SUBSTRING_FUNCTION_NAME, Utf8SubstringFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, UTF8_SUBSTRING_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(UTF8_REVERSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(UTF8_REVERSE_FUNCTION_NAME, Utf8ReverseFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, UTF8_REVERSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, VMArray<BSFixedString>, BSFixedString>(JOIN_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(JOIN_FUNCTION_NAME, JoinFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, JOIN_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, VMArray<BSFixedString>, BSFixedString, BSFixedString>(SPLIT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, SplitFunction, vm));
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, VMArray<BSFixedString>, BSFixedString, BSFixedString>(SPLIT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SPLIT_FUNCTION_NAME, SplitFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SPLIT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, VMArray<SInt32>>(ORDINAL_JOIN_FUNCTION_NAME, PAPYRUS_CLASS_NAME, OrdinalJoinFunction, vm));
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, VMArray<BSFixedString>, BSFixedString, BSFixedString, bool>(SPLIT_ANY_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SPLIT_ANY_FUNCTION_NAME, SplitAnyFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SPLIT_ANY_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, VMArray<BSFixedString>, BSFixedString>(SPLIT_WHITESPACE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SPLIT_WHITESPACE_FUNCTION_NAME, SplitWhitespaceFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SPLIT_WHITESPACE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, BSFixedString, BSFixedString>(TOKEN_COUNT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TOKEN_COUNT_FUNCTION_NAME, TokenCountFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TOKEN_COUNT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, BSFixedString, BSFixedString, SInt32>(TOKEN_AT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TOKEN_AT_FUNCTION_NAME, TokenAtFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TOKEN_AT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, VMArray<SInt32>>(ORDINAL_JOIN_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ORDINAL_JOIN_FUNCTION_NAME, OrdinalJoinFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ORDINAL_JOIN_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, VMArray<SInt32>, BSFixedString>(ORDINAL_SPLIT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, OrdinalSplitFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, VMArray<SInt32>, BSFixedString>(ORDINAL_SPLIT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ORDINAL_SPLIT_FUNCTION_NAME, OrdinalSplitFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ORDINAL_SPLIT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
-        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, VMArray<BSFixedString>, VMArray<BSFixedString>>(SORT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, SortFunction, vm));
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(BASE64_ENCODE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(BASE64_ENCODE_FUNCTION_NAME, Base64EncodeFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, BASE64_ENCODE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(BASE64_DECODE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(BASE64_DECODE_FUNCTION_NAME, Base64DecodeFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, BASE64_DECODE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(HEX_ENCODE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(HEX_ENCODE_FUNCTION_NAME, HexEncodeFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, HEX_ENCODE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(HEX_DECODE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(HEX_DECODE_FUNCTION_NAME, HexDecodeFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, HEX_DECODE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, VMArray<SInt32>>(ORDINAL_ARRAY_TO_BASE64_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ORDINAL_ARRAY_TO_BASE64_FUNCTION_NAME, OrdinalArrayToBase64Function), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ORDINAL_ARRAY_TO_BASE64_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, VMArray<SInt32>, BSFixedString>(BASE64_TO_ORDINAL_ARRAY_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(BASE64_TO_ORDINAL_ARRAY_FUNCTION_NAME, Base64ToOrdinalArrayFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, BASE64_TO_ORDINAL_ARRAY_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, VMArray<BSFixedString>, VMArray<BSFixedString>>(SORT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SORT_FUNCTION_NAME, SortFunction), vm));
         vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SORT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
 
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, VMArray<BSFixedString>, VMArray<BSFixedString>, bool, bool>(SORT_NATURAL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SORT_NATURAL_FUNCTION_NAME, SortNaturalFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SORT_NATURAL_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, VMArray<SInt32>, VMArray<BSFixedString>, bool, bool>(SORT_INDICES_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SORT_INDICES_FUNCTION_NAME, SortIndicesFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SORT_INDICES_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, VMArray<SInt32>, VMArray<BSFixedString>, bool, bool>(SORT_NATURAL_INDICES_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SORT_NATURAL_INDICES_FUNCTION_NAME, SortNaturalIndicesFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SORT_NATURAL_INDICES_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, VMArray<BSFixedString>, VMArray<BSFixedString>>(DISTINCT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(DISTINCT_FUNCTION_NAME, DistinctFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, DISTINCT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, VMArray<BSFixedString>, VMArray<BSFixedString>, VMArray<BSFixedString>>(UNION_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(UNION_FUNCTION_NAME, UnionFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, UNION_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, VMArray<BSFixedString>, VMArray<BSFixedString>, VMArray<BSFixedString>>(INTERSECT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(INTERSECT_FUNCTION_NAME, IntersectFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, INTERSECT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, VMArray<BSFixedString>, VMArray<BSFixedString>, VMArray<BSFixedString>>(DIFFERENCE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(DIFFERENCE_FUNCTION_NAME, DifferenceFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, DIFFERENCE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, VMArray<BSFixedString>>(COUNT_DISTINCT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(COUNT_DISTINCT_FUNCTION_NAME, CountDistinctFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, COUNT_DISTINCT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, VMArray<BSFixedString>, BSFixedString>(BINARY_SEARCH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(BINARY_SEARCH_FUNCTION_NAME, BinarySearchFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, BINARY_SEARCH_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, VMArray<SInt32>, VMArray<BSFixedString>, VMArray<BSFixedString>>(BINARY_SEARCH_MANY_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(BINARY_SEARCH_MANY_FUNCTION_NAME, BinarySearchManyFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, BINARY_SEARCH_MANY_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, VMArray<BSFixedString>, BSFixedString>(LOWER_BOUND_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(LOWER_BOUND_FUNCTION_NAME, LowerBoundFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, LOWER_BOUND_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, VMArray<BSFixedString>, BSFixedString>(UPPER_BOUND_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(UPPER_BOUND_FUNCTION_NAME, UpperBoundFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, UPPER_BOUND_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, VMArray<SInt32>, VMArray<BSFixedString>, BSFixedString>(EQUAL_RANGE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(EQUAL_RANGE_FUNCTION_NAME, EqualRangeFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, EQUAL_RANGE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, VMArray<BSFixedString>>(TEXT_INDEX_BUILD_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TEXT_INDEX_BUILD_FUNCTION_NAME, TextIndexBuildFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TEXT_INDEX_BUILD_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, VMArray<SInt32>, SInt32, BSFixedString>(TEXT_INDEX_QUERY_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TEXT_INDEX_QUERY_FUNCTION_NAME, TextIndexQueryFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TEXT_INDEX_QUERY_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, SInt32>(TEXT_INDEX_CLOSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TEXT_INDEX_CLOSE_FUNCTION_NAME, TextIndexCloseFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TEXT_INDEX_CLOSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, BSFixedString>(CURSOR_OPEN_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(CURSOR_OPEN_FUNCTION_NAME, CursorOpenFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, CURSOR_OPEN_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, SInt32>(CURSOR_NEXT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(CURSOR_NEXT_FUNCTION_NAME, CursorNextFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, CURSOR_NEXT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, SInt32>(CURSOR_PEEK_ORDINAL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(CURSOR_PEEK_ORDINAL_FUNCTION_NAME, CursorPeekOrdinalFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, CURSOR_PEEK_ORDINAL_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, SInt32, SInt32>(CURSOR_SKIP_WHILE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(CURSOR_SKIP_WHILE_FUNCTION_NAME, CursorSkipWhileFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, CURSOR_SKIP_WHILE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, SInt32, BSFixedString>(CURSOR_TAKE_UNTIL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(CURSOR_TAKE_UNTIL_FUNCTION_NAME, CursorTakeUntilFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, CURSOR_TAKE_UNTIL_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, SInt32>(CURSOR_CLOSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(CURSOR_CLOSE_FUNCTION_NAME, CursorCloseFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, CURSOR_CLOSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, BSFixedString>(DOC_CREATE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(DOC_CREATE_FUNCTION_NAME, DocCreateFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, DOC_CREATE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, SInt32>(DOC_LENGTH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(DOC_LENGTH_FUNCTION_NAME, DocLengthFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, DOC_LENGTH_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, bool, SInt32, SInt32, BSFixedString>(DOC_INSERT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(DOC_INSERT_FUNCTION_NAME, DocInsertFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, DOC_INSERT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, bool, SInt32, SInt32, SInt32>(DOC_DELETE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(DOC_DELETE_FUNCTION_NAME, DocDeleteFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, DOC_DELETE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction4<StaticFunctionTag, bool, SInt32, SInt32, SInt32, BSFixedString>(DOC_REPLACE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(DOC_REPLACE_FUNCTION_NAME, DocReplaceFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, DOC_REPLACE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, SInt32, SInt32, SInt32>(DOC_SUBSTRING_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(DOC_SUBSTRING_FUNCTION_NAME, DocSubstringFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, DOC_SUBSTRING_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, SInt32, SInt32, BSFixedString, SInt32>(DOC_SEARCH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(DOC_SEARCH_FUNCTION_NAME, DocSearchFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, DOC_SEARCH_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, SInt32>(DOC_TO_STRING_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(DOC_TO_STRING_FUNCTION_NAME, DocToStringFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, DOC_TO_STRING_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, SInt32>(DOC_CLOSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(DOC_CLOSE_FUNCTION_NAME, DocCloseFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, DOC_CLOSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, VMArray<BSFixedString>, SInt32>(SORT_ASYNC_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(SORT_ASYNC_FUNCTION_NAME, SortAsyncFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, SORT_ASYNC_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction4<StaticFunctionTag, SInt32, BSFixedString, BSFixedString, BSFixedString, SInt32>(REPLACE_ALL_ASYNC_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(REPLACE_ALL_ASYNC_FUNCTION_NAME, ReplaceAllAsyncFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, REPLACE_ALL_ASYNC_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, SInt32>(ASYNC_STATUS_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ASYNC_STATUS_FUNCTION_NAME, AsyncStatusFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ASYNC_STATUS_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, SInt32>(ASYNC_IS_DONE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ASYNC_IS_DONE_FUNCTION_NAME, AsyncIsDoneFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ASYNC_IS_DONE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, SInt32>(ASYNC_RESULT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ASYNC_RESULT_FUNCTION_NAME, AsyncResultFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ASYNC_RESULT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, VMArray<BSFixedString>, SInt32>(ASYNC_RESULT_ARRAY_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ASYNC_RESULT_ARRAY_FUNCTION_NAME, AsyncResultArrayFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ASYNC_RESULT_ARRAY_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, SInt32>(ASYNC_CANCEL_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ASYNC_CANCEL_FUNCTION_NAME, AsyncCancelFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ASYNC_CANCEL_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, SInt32>(ASYNC_CLOSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(ASYNC_CLOSE_FUNCTION_NAME, AsyncCloseFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, ASYNC_CLOSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, BSFixedString, BSFixedString>(READ_TEXT_FILE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(READ_TEXT_FILE_FUNCTION_NAME, ReadTextFileFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, READ_TEXT_FILE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, VMArray<BSFixedString>, BSFixedString>(READ_LINES_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(READ_LINES_FUNCTION_NAME, ReadLinesFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, READ_LINES_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, BSFixedString, SInt32>(READ_LINE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(READ_LINE_FUNCTION_NAME, ReadLineFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, READ_LINE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, BSFixedString>(JSON_PARSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(JSON_PARSE_FUNCTION_NAME, JsonParseFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, JSON_PARSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, BSFixedString>(JSON_PARSE_FILE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(JSON_PARSE_FILE_FUNCTION_NAME, JsonParseFileFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, JSON_PARSE_FILE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, SInt32, SInt32, BSFixedString>(JSON_GET_TYPE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(JSON_GET_TYPE_FUNCTION_NAME, JsonGetTypeFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, JSON_GET_TYPE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, BSFixedString, SInt32, BSFixedString, BSFixedString>(JSON_GET_STRING_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(JSON_GET_STRING_FUNCTION_NAME, JsonGetStringFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, JSON_GET_STRING_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, SInt32, SInt32, BSFixedString, SInt32>(JSON_GET_INT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(JSON_GET_INT_FUNCTION_NAME, JsonGetIntFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, JSON_GET_INT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction3<StaticFunctionTag, float, SInt32, BSFixedString, float>(JSON_GET_FLOAT_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(JSON_GET_FLOAT_FUNCTION_NAME, JsonGetFloatFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, JSON_GET_FLOAT_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, VMArray<BSFixedString>, SInt32, BSFixedString>(JSON_GET_ARRAY_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(JSON_GET_ARRAY_FUNCTION_NAME, JsonGetArrayFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, JSON_GET_ARRAY_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, SInt32>(JSON_CLOSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(JSON_CLOSE_FUNCTION_NAME, JsonCloseFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, JSON_CLOSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, BSFixedString>(INI_LOAD_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(INI_LOAD_FUNCTION_NAME, IniLoadFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, INI_LOAD_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction4<StaticFunctionTag, BSFixedString, SInt32, BSFixedString, BSFixedString, BSFixedString>(INI_GET_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(INI_GET_FUNCTION_NAME, IniGetFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, INI_GET_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, SInt32>(INI_CLOSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(INI_CLOSE_FUNCTION_NAME, IniCloseFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, INI_CLOSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, SInt32, BSFixedString>(STRINGS_TABLE_OPEN_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(STRINGS_TABLE_OPEN_FUNCTION_NAME, StringsTableOpenFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, STRINGS_TABLE_OPEN_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, BSFixedString, SInt32, SInt32>(STRINGS_TABLE_GET_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(STRINGS_TABLE_GET_FUNCTION_NAME, StringsTableGetFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, STRINGS_TABLE_GET_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction2<StaticFunctionTag, VMArray<BSFixedString>, SInt32, VMArray<SInt32>>(STRINGS_TABLE_GET_MANY_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(STRINGS_TABLE_GET_MANY_FUNCTION_NAME, StringsTableGetManyFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, STRINGS_TABLE_GET_MANY_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction1<StaticFunctionTag, bool, SInt32>(STRINGS_TABLE_CLOSE_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(STRINGS_TABLE_CLOSE_FUNCTION_NAME, StringsTableCloseFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, STRINGS_TABLE_CLOSE_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction0<StaticFunctionTag, BSFixedString>(GET_STATS_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(GET_STATS_FUNCTION_NAME, GetStatsFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, GET_STATS_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction0<StaticFunctionTag, void>(RESET_STATS_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(RESET_STATS_FUNCTION_NAME, ResetStatsFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, RESET_STATS_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
+        vm->RegisterFunction(new NativeFunction0<StaticFunctionTag, BSFixedString>(TRACE_FLUSH_FUNCTION_NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(TRACE_FLUSH_FUNCTION_NAME, TraceFlushFunction), vm));
+        vm->SetFunctionFlags(PAPYRUS_CLASS_NAME, TRACE_FLUSH_FUNCTION_NAME, IFunction::kFunctionFlag_NoWait);
+
         return true;
     }
 }
@@ -4,9 +4,14 @@
 // Plugin Papyrus Functions
 // ========================
 
+#include <cctype>                           // for std::tolower
 #include <string>
 
+#include "charclass.h"                      // for IsCharOfClass
+
 #define PAPYRUS_CLASS_NAME                 "FO4StringUtils"    // Name of the Papyrus class for registration
+#define PLUGIN_INI_FILE_PATH               ".\\Data\\F4SE\\Plugins\\FO4StringUtils.ini"    // Optional settings, relative to the game folder
+#define ASYNC_EVENT_NAME                   "FO4StringUtils_AsyncDone"    // External event sent with (handle, status) when an *Async job ends
 
 #define PLUGIN_VERSION_FUNCTION_NAME       "PluginVersion"
 #define GAME_VERSION_FUNCTION_NAME         "GameVersion"
@@ -21,12 +26,16 @@
 #define SEARCH_REVERSE_FUNCTION_NAME       "SearchReverse"
 #define SEARCH_INDEX_FUNCTION_NAME         "SearchIndex"
 #define SEARCH_INDEX_REVERSE_FUNCTION_NAME "SearchIndexReverse"
+#define FIND_ALL_FUNCTION_NAME             "FindAll"
+#define COUNT_OCCURRENCES_FUNCTION_NAME    "CountOccurrences"
+#define COUNT_CHAR_FUNCTION_NAME           "CountChar"
 #define CONTAINS_FUNCTION_NAME             "Contains"
 #define STARTS_WITH_FUNCTION_NAME          "StartsWith"
 #define ENDS_WITH_FUNCTION_NAME            "EndsWith"
 #define REPLACE_FUNCTION_NAME              "Replace"
 #define REPLACE_ALL_FUNCTION_NAME          "ReplaceAll"
 #define REPLACE_INDEX_FUNCTION_NAME        "ReplaceIndex"
+#define APPLY_EDITS_FUNCTION_NAME          "ApplyEdits"
 #define SUBSTRING_FUNCTION_NAME            "Substring"
 #define CHAR_AT_FUNCTION_NAME              "CharAt"
 #define ORDINAL_AT_FUNCTION_NAME           "OrdinalAt"
@@ -34,12 +43,18 @@
 #define REMOVE_ALL_FUNCTION_NAME           "RemoveAll"
 #define REVERSE_FUNCTION_NAME              "Reverse"
 #define REPEAT_FUNCTION_NAME               "Repeat"
+#define PAD_LEFT_FUNCTION_NAME             "PadLeft"
+#define PAD_RIGHT_FUNCTION_NAME            "PadRight"
+#define CENTER_FUNCTION_NAME               "Center"
 #define TO_CHAR_FUNCTION_NAME              "ToChar"
 #define TO_TITLE_CASE_FUNCTION_NAME        "ToTitleCase"
 #define TO_ORDINAL_FUNCTION_NAME           "ToOrdinal"
 #define TRIM_START_FUNCTION_NAME           "TrimStart"
 #define TRIM_END_FUNCTION_NAME             "TrimEnd"
 #define TRIM_BOTH_FUNCTION_NAME            "TrimBoth"
+#define COLLAPSE_WHITESPACE_FUNCTION_NAME  "CollapseWhitespace"
+#define STRIP_CONTROL_FUNCTION_NAME        "StripControl"
+#define TRANSFORM_FUNCTION_NAME            "Transform"
 #define IS_ALPHA_FUNCTION_NAME             "IsAlpha"
 #define IS_DIGIT_FUNCTION_NAME             "IsDigit"
 #define IS_HEX_FUNCTION_NAME               "IsHex"
@@ -50,17 +65,92 @@
 #define IS_CONTROL_FUNCTION_NAME           "IsControl"
 #define IS_PRINTABLE_FUNCTION_NAME         "IsPrintable"
 #define IS_GRAPH_FUNCTION_NAME             "IsGraph"
+#define IS_ALL_OF_CLASS_FUNCTION_NAME      "IsAllOfClass"
+#define UTF8_COUNT_FUNCTION_NAME           "Utf8Count"
+#define UTF8_IS_VALID_FUNCTION_NAME        "Utf8IsValid"
+#define UTF8_CHAR_AT_FUNCTION_NAME         "Utf8CharAt"
+#define UTF8_SUBSTRING_FUNCTION_NAME       "Utf8Substring"
+#define UTF8_REVERSE_FUNCTION_NAME         "Utf8Reverse"
 #define JOIN_FUNCTION_NAME                 "Join"
 #define SPLIT_FUNCTION_NAME                "Split"
+#define SPLIT_ANY_FUNCTION_NAME            "SplitAny"
+#define SPLIT_WHITESPACE_FUNCTION_NAME     "SplitWhitespace"
+#define TOKEN_COUNT_FUNCTION_NAME          "TokenCount"
+#define TOKEN_AT_FUNCTION_NAME             "TokenAt"
 #define ORDINAL_JOIN_FUNCTION_NAME         "OrdinalJoin"
 #define ORDINAL_SPLIT_FUNCTION_NAME        "OrdinalSplit"
+#define BASE64_ENCODE_FUNCTION_NAME        "Base64Encode"
+#define BASE64_DECODE_FUNCTION_NAME        "Base64Decode"
+#define HEX_ENCODE_FUNCTION_NAME           "HexEncode"
+#define HEX_DECODE_FUNCTION_NAME           "HexDecode"
+#define ORDINAL_ARRAY_TO_BASE64_FUNCTION_NAME "OrdinalArrayToBase64"
+#define BASE64_TO_ORDINAL_ARRAY_FUNCTION_NAME "Base64ToOrdinalArray"
 #define SORT_FUNCTION_NAME                 "Sort"
+#define SORT_NATURAL_FUNCTION_NAME         "SortNatural"
+#define SORT_INDICES_FUNCTION_NAME         "SortIndices"
+#define SORT_NATURAL_INDICES_FUNCTION_NAME "SortNaturalIndices"
+#define DISTINCT_FUNCTION_NAME             "Distinct"
+#define UNION_FUNCTION_NAME                "Union"
+#define INTERSECT_FUNCTION_NAME            "Intersect"
+#define DIFFERENCE_FUNCTION_NAME           "Difference"
+#define COUNT_DISTINCT_FUNCTION_NAME       "CountDistinct"
+#define BINARY_SEARCH_FUNCTION_NAME        "BinarySearch"
+#define BINARY_SEARCH_MANY_FUNCTION_NAME   "BinarySearchMany"
+#define LOWER_BOUND_FUNCTION_NAME          "LowerBound"
+#define UPPER_BOUND_FUNCTION_NAME          "UpperBound"
+#define EQUAL_RANGE_FUNCTION_NAME          "EqualRange"
+#define TEXT_INDEX_BUILD_FUNCTION_NAME     "TextIndexBuild"
+#define TEXT_INDEX_QUERY_FUNCTION_NAME     "TextIndexQuery"
+#define TEXT_INDEX_CLOSE_FUNCTION_NAME     "TextIndexClose"
+#define CURSOR_OPEN_FUNCTION_NAME          "CursorOpen"
+#define CURSOR_NEXT_FUNCTION_NAME          "CursorNext"
+#define CURSOR_PEEK_ORDINAL_FUNCTION_NAME  "CursorPeekOrdinal"
+#define CURSOR_SKIP_WHILE_FUNCTION_NAME    "CursorSkipWhile"
+#define CURSOR_TAKE_UNTIL_FUNCTION_NAME    "CursorTakeUntil"
+#define CURSOR_CLOSE_FUNCTION_NAME         "CursorClose"
+#define DOC_CREATE_FUNCTION_NAME           "DocCreate"
+#define DOC_LENGTH_FUNCTION_NAME           "DocLength"
+#define DOC_INSERT_FUNCTION_NAME           "DocInsert"
+#define DOC_DELETE_FUNCTION_NAME           "DocDelete"
+#define DOC_REPLACE_FUNCTION_NAME          "DocReplace"
+#define DOC_SUBSTRING_FUNCTION_NAME        "DocSubstring"
+#define DOC_SEARCH_FUNCTION_NAME           "DocSearch"
+#define DOC_TO_STRING_FUNCTION_NAME        "DocToString"
+#define DOC_CLOSE_FUNCTION_NAME            "DocClose"
+#define SORT_ASYNC_FUNCTION_NAME           "SortAsync"
+#define REPLACE_ALL_ASYNC_FUNCTION_NAME    "ReplaceAllAsync"
+#define ASYNC_STATUS_FUNCTION_NAME         "AsyncStatus"
+#define ASYNC_IS_DONE_FUNCTION_NAME        "AsyncIsDone"
+#define ASYNC_RESULT_FUNCTION_NAME         "AsyncResult"
+#define ASYNC_RESULT_ARRAY_FUNCTION_NAME   "AsyncResultArray"
+#define ASYNC_CANCEL_FUNCTION_NAME         "AsyncCancel"
+#define ASYNC_CLOSE_FUNCTION_NAME          "AsyncClose"
+#define READ_TEXT_FILE_FUNCTION_NAME       "ReadTextFile"
+#define READ_LINES_FUNCTION_NAME           "ReadLines"
+#define READ_LINE_FUNCTION_NAME            "ReadLine"
+#define JSON_PARSE_FUNCTION_NAME           "JsonParse"
+#define JSON_PARSE_FILE_FUNCTION_NAME      "JsonParseFile"
+#define JSON_GET_TYPE_FUNCTION_NAME        "JsonGetType"
+#define JSON_GET_STRING_FUNCTION_NAME      "JsonGetString"
+#define JSON_GET_INT_FUNCTION_NAME         "JsonGetInt"
+#define JSON_GET_FLOAT_FUNCTION_NAME       "JsonGetFloat"
+#define JSON_GET_ARRAY_FUNCTION_NAME       "JsonGetArray"
+#define JSON_CLOSE_FUNCTION_NAME           "JsonClose"
+#define INI_LOAD_FUNCTION_NAME             "IniLoad"
+#define INI_GET_FUNCTION_NAME              "IniGet"
+#define INI_CLOSE_FUNCTION_NAME            "IniClose"
+#define STRINGS_TABLE_OPEN_FUNCTION_NAME   "StringsTableOpen"
+#define STRINGS_TABLE_GET_FUNCTION_NAME    "StringsTableGet"
+#define STRINGS_TABLE_GET_MANY_FUNCTION_NAME "StringsTableGetMany"
+#define STRINGS_TABLE_CLOSE_FUNCTION_NAME  "StringsTableClose"
+#define GET_STATS_FUNCTION_NAME            "GetStats"
+#define RESET_STATS_FUNCTION_NAME          "ResetStats"
+#define TRACE_FLUSH_FUNCTION_NAME          "TraceFlush"
 
 class VirtualMachine;
 
 namespace Papyrus
 {
-    const std::string WHITESPACE_CHARS = " \t\n\r";
     const std::string EMPTY_STRING = "";
     constexpr int NOT_FOUND = -1;
     constexpr int UPPER_BOUND_ASCII = 127;
@@ -69,7 +159,56 @@ namespace Papyrus
     // Prevent insane allocations (Papyrus-safe upper bound)
     constexpr size_t MAX_OUTPUT_SIZE = static_cast<size_t>(1024u) * 1024u * 16u;
 
+    // Return if a character is a word separator
+    //
+    inline bool IsWordSeparator(char c)
+    {
+        return !IsCharOfClass<kCharClass_Alpha>(static_cast<unsigned char>(c));
+    }
+
+    // Lowercase copy used for case-insensitive matching
+    //
+    inline std::string ToLowerCopy(const std::string& str)
+    {
+        std::string result;
+        result.reserve(str.size());
+
+        for (unsigned char c : str)
+        {
+            result.push_back(static_cast<char>(std::tolower(c)));
+        }
+
+        return result;
+    }
+
+    // Orders two strings as CompareFunction does, folding each character as
+    // it goes rather than building lowercase copies first
+    //
+    inline int FoldedCompare(const char* left, const char* right)
+    {
+        for (;; left++, right++)
+        {
+            const int l = std::tolower(static_cast<unsigned char>(*left));
+            const int r = std::tolower(static_cast<unsigned char>(*right));
+
+            if (l != r)
+            {
+                return l < r ? -1 : 1;
+            }
+            if (l == 0)
+            {
+                return 0;
+            }
+        }
+    }
+
     bool RegisterFunctions(VirtualMachine* vm);
+
+    // Handles held by scripts do not survive a load. Closes every open
+    // index, cursor, document, JSON, INI, string table and *Async handle,
+    // cancelling the jobs and silencing their completion events.
+    //
+    void CloseAllHandles();
 }
 
 // +-----------------------------------+
@@ -0,0 +1,102 @@
+#pragma once
+
+// ======================
+// Papyrus Object Handles
+// ======================
+
+#include <memory>                           // for std::shared_ptr
+#include <mutex>                            // for std::mutex
+#include <random>                           // for std::random_device
+#include <unordered_map>                    // for std::unordered_map
+
+namespace Papyrus
+{
+    // Handle value returned when an object could not be created
+    constexpr SInt32 INVALID_HANDLE = 0;
+
+    // Prevent scripts from leaking unbounded native objects
+    constexpr size_t MAX_HANDLES_PER_TYPE = 4096;
+
+    // Maps the Int handles given to Papyrus onto native objects.
+    //
+    // Natives may run concurrently on several VM threads, so every access is
+    // serialized. Objects are handed out as shared_ptr so a Close from one
+    // thread cannot free an object another thread is still using.
+    //
+    template <typename T>
+    class HandleRegistry
+    {
+    public:
+        // Usage: SInt32 handle = registry.Add(std::make_shared<T>(...));
+        //
+        SInt32 Add(std::shared_ptr<T> item)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            // Refuse new objects once the script has too many open
+            if (!item || m_items.size() >= MAX_HANDLES_PER_TYPE)
+            {
+                return INVALID_HANDLE;
+            }
+
+            // Skip over invalid and still-used values when wrapping around
+            do
+            {
+                if (++m_next <= INVALID_HANDLE)
+                {
+                    m_next = INVALID_HANDLE + 1;
+                }
+            } while (m_items.count(m_next) != 0);
+
+            m_items[m_next] = std::move(item);
+            return m_next;
+        }
+
+        // Returns nullptr for unknown or closed handles
+        //
+        std::shared_ptr<T> Get(SInt32 handle)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            auto it = m_items.find(handle);
+            return it != m_items.end() ? it->second : nullptr;
+        }
+
+        // Returns false if the handle was not open
+        //
+        bool Remove(SInt32 handle)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            return m_items.erase(handle) != 0;
+        }
+
+        // Closes every handle. Objects still in use elsewhere live on until
+        // released there.
+        //
+        void Clear()
+        {
+            Clear([](T&) {});
+        }
+
+        // As Clear, calling visit on each object before its handle closes
+        //
+        template <typename Visitor>
+        void Clear(Visitor visit)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            for (auto& entry : m_items)
+            {
+                visit(*entry.second);
+            }
+            m_items.clear();
+        }
+
+    private:
+        std::mutex m_lock;
+        std::unordered_map<SInt32, std::shared_ptr<T>> m_items;
+        // Starts somewhere different each launch, so an Int a script kept in
+        // a save from an earlier launch is unlikely to name a live object
+        SInt32 m_next = static_cast<SInt32>(std::random_device()() & 0x3FFFFFFF);
+    };
+}
@@ -0,0 +1,209 @@
+// ==================
+// INI Configurations
+// ==================
+
+#include <algorithm>                        // for std::stable_sort, std::lower_bound
+#include <cctype>                           // for std::tolower
+#include <cstring>                          // for memchr
+#include <mutex>                            // for std::mutex
+
+#include "inifile.h"                        // for IniFile
+#include "textfile.h"                       // for OpenDataTextFile
+
+namespace Papyrus
+{
+    namespace
+    {
+        struct CachedIni
+        {
+            std::weak_ptr<MappedTextFile> source;   // expires once the text cache drops or replaces the file
+            std::shared_ptr<IniFile> ini;
+            UInt64 lastUse;
+        };
+
+        std::mutex g_cacheLock;
+        std::vector<CachedIni> g_cache;
+        UInt64 g_cacheClock = 0;
+
+        inline bool IsIniSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+        }
+
+        // Narrow [begin, end) to exclude surrounding spaces and tabs
+        //
+        inline void Trim(const char*& begin, const char*& end)
+        {
+            while (begin < end && IsIniSpace(*begin))
+            {
+                begin++;
+            }
+            while (end > begin && IsIniSpace(end[-1]))
+            {
+                end--;
+            }
+        }
+
+        inline std::string FoldCopy(const char* begin, const char* end)
+        {
+            std::string result(begin, end);
+            for (char& c : result)
+            {
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            return result;
+        }
+    }
+
+    IniFile::IniFile(const char* text, size_t length)
+    {
+        const char* const textEnd = text + length;
+        std::string section;
+
+        for (const char* line = text; line < textEnd;)
+        {
+            const char* newline = static_cast<const char*>(memchr(line, '\n', textEnd - line));
+            const char* lineEnd = newline ? newline : textEnd;
+            const char* next = newline ? newline + 1 : textEnd;
+
+            const char* begin = line;
+            const char* end = lineEnd;
+            Trim(begin, end);
+            line = next;
+
+            if (begin == end || *begin == ';' || *begin == '#')
+            {
+                continue;
+            }
+
+            if (*begin == '[')
+            {
+                // Lines such as "[Section" with no closing bracket are skipped
+                const char* close = static_cast<const char*>(memchr(begin, ']', end - begin));
+                if (close)
+                {
+                    const char* nameBegin = begin + 1;
+                    const char* nameEnd = close;
+                    Trim(nameBegin, nameEnd);
+                    section = FoldCopy(nameBegin, nameEnd);
+                }
+                continue;
+            }
+
+            const char* equals = static_cast<const char*>(memchr(begin, '=', end - begin));
+            if (!equals)
+            {
+                continue;
+            }
+
+            const char* keyEnd = equals;
+            const char* valueBegin = equals + 1;
+            const char* valueEnd = end;
+            Trim(begin, keyEnd);
+            Trim(valueBegin, valueEnd);
+
+            // A value wrapped in double quotes keeps its inner spaces without the quotes
+            if (valueEnd - valueBegin >= 2 && *valueBegin == '"' && valueEnd[-1] == '"')
+            {
+                valueBegin++;
+                valueEnd--;
+            }
+
+            m_rows.push_back(Row{ section, FoldCopy(begin, keyEnd), std::string(valueBegin, valueEnd) });
+        }
+
+        // Stable, so the first of any repeated key is the one kept
+        std::stable_sort(m_rows.begin(), m_rows.end(), [](const Row& a, const Row& b)
+        {
+            const int order = a.section.compare(b.section);
+            return order != 0 ? order < 0 : a.key < b.key;
+        });
+
+        m_rows.erase(std::unique(m_rows.begin(), m_rows.end(), [](const Row& a, const Row& b)
+        {
+            return a.section == b.section && a.key == b.key;
+        }), m_rows.end());
+
+        m_rows.shrink_to_fit();
+    }
+
+    const std::string* IniFile::Find(const std::string& section, const std::string& key) const
+    {
+        const std::string foldedSection = FoldCopy(section.data(), section.data() + section.size());
+        const std::string foldedKey = FoldCopy(key.data(), key.data() + key.size());
+
+        auto it = std::lower_bound(m_rows.begin(), m_rows.end(), foldedSection, [&foldedKey](const Row& row, const std::string& wanted)
+        {
+            const int order = row.section.compare(wanted);
+            return order != 0 ? order < 0 : row.key < foldedKey;
+        });
+
+        if (it == m_rows.end() || it->section != foldedSection || it->key != foldedKey)
+        {
+            return nullptr;
+        }
+
+        return &it->value;
+    }
+
+    std::shared_ptr<IniFile> LoadDataIniFile(const std::string& path)
+    {
+        // The text cache already checks size and modification time, and hands
+        // back the same file while both are unchanged
+        std::shared_ptr<MappedTextFile> file = OpenDataTextFile(path);
+        if (!file)
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(g_cacheLock);
+
+        for (CachedIni& entry : g_cache)
+        {
+            if (entry.source.lock() == file)
+            {
+                entry.lastUse = ++g_cacheClock;
+                return entry.ini;
+            }
+        }
+
+        std::shared_ptr<IniFile> ini = std::make_shared<IniFile>(file->Text(), file->Length());
+
+        // Reuse an expired entry, a free slot, or the least recently used
+        CachedIni* slot = nullptr;
+        for (CachedIni& entry : g_cache)
+        {
+            if (entry.source.expired())
+            {
+                slot = &entry;
+                break;
+            }
+        }
+
+        if (!slot)
+        {
+            if (g_cache.size() < INI_CACHE_ENTRIES)
+            {
+                g_cache.push_back(CachedIni());
+                slot = &g_cache.back();
+            }
+            else
+            {
+                slot = &g_cache[0];
+                for (CachedIni& entry : g_cache)
+                {
+                    if (entry.lastUse < slot->lastUse)
+                    {
+                        slot = &entry;
+                    }
+                }
+            }
+        }
+
+        slot->source = file;
+        slot->ini = ini;
+        slot->lastUse = ++g_cacheClock;
+
+        return ini;
+    }
+}
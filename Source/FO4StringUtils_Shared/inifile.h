@@ -0,0 +1,54 @@
+#pragma once
+
+// ==================
+// INI Configurations
+// ==================
+
+#include <memory>                           // for std::shared_ptr
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+namespace Papyrus
+{
+    // Parsed files kept for reuse while they are unchanged on disk
+    constexpr size_t INI_CACHE_ENTRIES = 8;
+
+    // An INI file parsed into one flat table of (section, key, value) rows.
+    //
+    // Rows are sorted by lowercased section and key, so a lookup is a binary
+    // search over contiguous memory. Lines starting with ';' or '#' are
+    // comments; keys before the first [section] belong to section "". When a
+    // key repeats within a section the first value wins, as it does for
+    // GetPrivateProfileString.
+    //
+    class IniFile
+    {
+    public:
+        IniFile(const char* text, size_t length);
+
+        // Returns nullptr if the section has no such key. Both names are
+        // matched without regard to case.
+        //
+        const std::string* Find(const std::string& section, const std::string& key) const;
+
+        size_t Count() const { return m_rows.size(); }
+
+    private:
+        struct Row
+        {
+            std::string section;    // lowercased
+            std::string key;        // lowercased
+            std::string value;
+        };
+
+        std::vector<Row> m_rows;
+    };
+
+    // Loads an INI file by a path relative to Data, with the same path rules
+    // as OpenDataTextFile. Loading a file again while its size and
+    // modification time are unchanged returns the table already parsed.
+    //
+    // Returns nullptr if the path is refused or the file cannot be read.
+    //
+    std::shared_ptr<IniFile> LoadDataIniFile(const std::string& path);
+}
@@ -0,0 +1,78 @@
+// ===========================
+// Native Call Instrumentation
+// ===========================
+
+#include <shlobj.h>                         // for SHGetFolderPathA
+
+#include "version.h"                        // for LogFilePath
+#include "functions.h"                      // for PLUGIN_INI_FILE_PATH
+#include "instrument.h"                     // for g_instrumentFlags
+
+namespace Papyrus
+{
+    std::atomic<UInt32> g_instrumentFlags(0);
+
+    std::string LogSiblingPath(const char* extension)
+    {
+        char documents[MAX_PATH] = {};
+        if (!SUCCEEDED(SHGetFolderPathA(NULL, CSIDL_MYDOCUMENTS, NULL, SHGFP_TYPE_CURRENT, documents)))
+        {
+            return std::string();
+        }
+
+        // "...\FO4StringUtils.log" -> "...\FO4StringUtils" + extension
+        std::string path = std::string(documents) + LogFilePath();
+        const size_t dot = path.rfind(".log");
+        if (dot != std::string::npos)
+        {
+            path.erase(dot);
+        }
+
+        return path + extension;
+    }
+
+    void LoadInstrumentConfig()
+    {
+        UInt32 flags = 0;
+
+        if (GetPrivateProfileIntA("Stats", "bEnabled", 0, PLUGIN_INI_FILE_PATH) != 0)
+        {
+            flags |= kInstrument_Stats;
+        }
+        if (GetPrivateProfileIntA("Trace", "bEnabled", 0, PLUGIN_INI_FILE_PATH) != 0)
+        {
+            flags |= kInstrument_Trace;
+        }
+        if (GetPrivateProfileIntA("Capture", "bEnabled", 0, PLUGIN_INI_FILE_PATH) != 0)
+        {
+            flags |= kInstrument_Capture;
+        }
+
+        // Nothing enabled: skip the calibration sleep entirely
+        if (flags == 0)
+        {
+            return;
+        }
+
+        Stats::CalibrateTicks();
+
+        if (flags & kInstrument_Stats)
+        {
+            Stats::Start(GetPrivateProfileIntA("Stats", "iDumpIntervalSeconds", 0, PLUGIN_INI_FILE_PATH));
+        }
+        if (flags & kInstrument_Trace)
+        {
+            Trace::Start(GetPrivateProfileIntA("Trace", "iBufferEvents", Trace::DEFAULT_CAPACITY, PLUGIN_INI_FILE_PATH));
+        }
+        if (flags & kInstrument_Capture)
+        {
+            const UInt32 maxMegabytes = GetPrivateProfileIntA("Capture", "iMaxMegabytes", Capture::DEFAULT_MAX_MEGABYTES, PLUGIN_INI_FILE_PATH);
+            if (!Capture::Start(LogSiblingPath(".capture.bin"), maxMegabytes))
+            {
+                flags &= ~kInstrument_Capture;
+            }
+        }
+
+        g_instrumentFlags.store(flags);
+    }
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+// ==========================
+// Native Call Instrumentation
+// ==========================
+
+// F4SE
+#include "f4se/PapyrusNativeFunctions.h"    // for BSFixedString, VMArray
+
+#include <atomic>                           // for std::atomic
+#include <cstring>                          // for strlen
+#include <utility>                          // for std::move
+
+#include "capture.h"                        // for Capture
+#include "stats.h"                          // for Stats
+#include "trace.h"                          // for Trace
+
+namespace Papyrus
+{
+    // What the INSTRUMENT wrapper records, from the plugin INI
+    enum InstrumentFlags : UInt32
+    {
+        kInstrument_Stats = 1 << 0,
+        kInstrument_Trace = 1 << 1,
+        kInstrument_Capture = 1 << 2,
+    };
+
+    // Written once by LoadInstrumentConfig, before any native is registered
+    extern std::atomic<UInt32> g_instrumentFlags;
+
+    // Read [Stats] and [Trace] from the plugin INI and start what is enabled
+    //
+    void LoadInstrumentConfig();
+
+    // Usage: LogSiblingPath(".trace.json") -> "...\F4SE\FO4StringUtils.trace.json"
+    //
+    std::string LogSiblingPath(const char* extension);
+
+    // Arguments have to be captured before the call moves them into the native
+    //
+    template <typename... A>
+    inline void CaptureCall(UInt32 flags, UInt32 id, A&... args)
+    {
+        if (flags & kInstrument_Capture)
+        {
+            std::string payload;
+            Capture::PutArgs(payload, args...);
+            Capture::Record(id, payload);
+        }
+    }
+
+    inline void RecordCall(UInt32 flags, UInt32 id, UInt64 begin, UInt64 end, UInt64 bytesIn, UInt64 bytesOut)
+    {
+        if (flags & kInstrument_Stats)
+        {
+            Stats::Record(id, end - begin, bytesIn, bytesOut);
+        }
+        if (flags & kInstrument_Trace)
+        {
+            Trace::Record(id, begin, end, bytesIn, bytesOut);
+        }
+    }
+
+    // Approximate payload size of an argument or result for the byte tallies
+    //
+    inline UInt64 ArgBytes(const BSFixedString& value)
+    {
+        const char* str = value.c_str();
+        return str ? strlen(str) : 0;
+    }
+
+    inline UInt64 ArgBytes(VMArray<BSFixedString>& value)
+    {
+        UInt64 total = 0;
+        const UInt32 len = value.Length();
+        for (UInt32 i = 0; i < len; i++)
+        {
+            BSFixedString part;
+            value.Get(&part, i);
+            total += ArgBytes(part);
+        }
+        return total;
+    }
+
+    template <typename T>
+    inline UInt64 ArgBytes(VMArray<T>& value)
+    {
+        return static_cast<UInt64>(value.Length()) * sizeof(T);
+    }
+
+    template <typename T>
+    inline UInt64 ArgBytes(const T&)
+    {
+        return sizeof(T);
+    }
+
+    inline UInt64 SumArgBytes()
+    {
+        return 0;
+    }
+
+    template <typename T, typename... Rest>
+    inline UInt64 SumArgBytes(T& first, Rest&... rest)
+    {
+        return ArgBytes(first) + SumArgBytes(rest...);
+    }
+
+    // Wraps a native so each call is timed, traced or captured as configured.
+    // One instantiation exists per wrapped function, holding its stats id.
+    //
+    // The wrapper takes its arguments by value and passes copies on, which
+    // costs a refcount round trip per string and a copy per array. With
+    // instrumentation off Bind hands back the native itself instead.
+    //
+    template <typename Sig, Sig Fn>
+    struct Instrument;
+
+    template <typename R, typename... A, R (*Fn)(StaticFunctionTag*, A...)>
+    struct Instrument<R (*)(StaticFunctionTag*, A...), Fn>
+    {
+        static UInt32 id;
+
+        static R Call(StaticFunctionTag* base, A... args)
+        {
+            const UInt32 flags = g_instrumentFlags.load(std::memory_order_relaxed);
+
+            CaptureCall(flags, id, args...);
+
+            const UInt64 bytesIn = SumArgBytes(args...);
+            const UInt64 begin = Stats::Now();
+
+            R result = Fn(base, std::move(args)...);
+
+            const UInt64 end = Stats::Now();
+            RecordCall(flags, id, begin, end, bytesIn, ArgBytes(result));
+
+            return result;
+        }
+
+        // Usage: see INSTRUMENT
+        //
+        static R (*Bind(const char* name))(StaticFunctionTag*, A...)
+        {
+            id = Stats::RegisterFunction(name);
+            return g_instrumentFlags.load() ? &Call : Fn;
+        }
+    };
+
+    // Natives with no result, e.g. ResetStats
+    //
+    template <typename... A, void (*Fn)(StaticFunctionTag*, A...)>
+    struct Instrument<void (*)(StaticFunctionTag*, A...), Fn>
+    {
+        static UInt32 id;
+
+        static void Call(StaticFunctionTag* base, A... args)
+        {
+            const UInt32 flags = g_instrumentFlags.load(std::memory_order_relaxed);
+
+            CaptureCall(flags, id, args...);
+
+            const UInt64 bytesIn = SumArgBytes(args...);
+            const UInt64 begin = Stats::Now();
+
+            Fn(base, std::move(args)...);
+
+            RecordCall(flags, id, begin, Stats::Now(), bytesIn, 0);
+        }
+
+        static void (*Bind(const char* name))(StaticFunctionTag*, A...)
+        {
+            id = Stats::RegisterFunction(name);
+            return g_instrumentFlags.load() ? &Call : Fn;
+        }
+    };
+
+    template <typename R, typename... A, R (*Fn)(StaticFunctionTag*, A...)>
+    UInt32 Instrument<R (*)(StaticFunctionTag*, A...), Fn>::id = Stats::MAX_FUNCTIONS;
+
+    template <typename... A, void (*Fn)(StaticFunctionTag*, A...)>
+    UInt32 Instrument<void (*)(StaticFunctionTag*, A...), Fn>::id = Stats::MAX_FUNCTIONS;
+}
+
+// Usage: vm->RegisterFunction(new NativeFunction1<...>(NAME, PAPYRUS_CLASS_NAME, INSTRUMENT(NAME, Fn), vm));
+//
+// Only valid after LoadInstrumentConfig, which decides between Fn and its wrapper.
+//
+#define INSTRUMENT(name, fn) ::Papyrus::Instrument<decltype(&fn), &fn>::Bind(name)
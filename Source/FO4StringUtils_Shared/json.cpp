@@ -0,0 +1,782 @@
+// ==============
+// JSON Documents
+// ==============
+
+#include <cctype>                           // for std::tolower
+#include <cstdlib>                          // for strtod
+#include <cstring>                          // for memchr, memcpy, memset
+#include <mutex>                            // for std::mutex
+#include <utility>                          // for std::move
+
+#include "json.h"                           // for JsonDocument
+#include "simd.h"                           // for Simd
+
+namespace Papyrus
+{
+    namespace
+    {
+        // Lanes of one block holding each kind of character, lane 0 in bit 0
+        struct BlockMasks
+        {
+            UInt32 quotes;
+            UInt32 backslashes;
+            UInt32 structurals;             // { } [ ] : ,
+            UInt32 whitespace;              // space \t \n \r
+        };
+
+        inline bool IsJsonWhitespace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        inline bool IsJsonStructural(char c)
+        {
+            return c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+        }
+
+        inline BlockMasks ClassifyBlock(const char* block)
+        {
+            BlockMasks masks;
+#if PAPYRUS_SSE2
+            const __m128i v = Simd::Load(block);
+
+            // Setting bit 5 folds '[' onto '{' and ']' onto '}'
+            const __m128i folded = _mm_or_si128(v, Simd::Splat(0x20));
+            const __m128i brackets = _mm_or_si128(Simd::Equal(folded, '{'), Simd::Equal(folded, '}'));
+
+            masks.quotes = Simd::Mask(Simd::Equal(v, '"'));
+            masks.backslashes = Simd::Mask(Simd::Equal(v, '\\'));
+            masks.structurals = Simd::Mask(_mm_or_si128(brackets, _mm_or_si128(Simd::Equal(v, ':'), Simd::Equal(v, ','))));
+            masks.whitespace = Simd::Mask(_mm_or_si128(_mm_or_si128(Simd::Equal(v, ' '), Simd::Equal(v, '\t')),
+                                                       _mm_or_si128(Simd::Equal(v, '\n'), Simd::Equal(v, '\r'))));
+#else
+            masks = BlockMasks();
+
+            for (UInt32 i = 0; i < Simd::WIDTH; i++)
+            {
+                const UInt32 lane = 1u << i;
+                masks.quotes |= block[i] == '"' ? lane : 0;
+                masks.backslashes |= block[i] == '\\' ? lane : 0;
+                masks.structurals |= IsJsonStructural(block[i]) ? lane : 0;
+                masks.whitespace |= IsJsonWhitespace(block[i]) ? lane : 0;
+            }
+#endif
+            return masks;
+        }
+
+        // Bit i is set when an odd number of bits are set at or below i
+        //
+        inline UInt32 PrefixXor(UInt32 bits)
+        {
+            bits ^= bits << 1;
+            bits ^= bits << 2;
+            bits ^= bits << 4;
+            bits ^= bits << 8;
+            return bits & Simd::FULL_MASK;
+        }
+
+        // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+        //
+        bool IsJsonNumber(const char* p, size_t length)
+        {
+            size_t i = 0;
+            auto digits = [&]()
+            {
+                const size_t first = i;
+                while (i < length && p[i] >= '0' && p[i] <= '9')
+                {
+                    i++;
+                }
+                return i - first;
+            };
+
+            if (i < length && p[i] == '-')
+            {
+                i++;
+            }
+
+            // No leading zeros
+            const size_t integerStart = i;
+            const size_t integerDigits = digits();
+            if (integerDigits == 0 || (integerDigits > 1 && p[integerStart] == '0'))
+            {
+                return false;
+            }
+
+            if (i < length && p[i] == '.')
+            {
+                i++;
+                if (digits() == 0)
+                {
+                    return false;
+                }
+            }
+
+            if (i < length && (p[i] == 'e' || p[i] == 'E'))
+            {
+                i++;
+                if (i < length && (p[i] == '+' || p[i] == '-'))
+                {
+                    i++;
+                }
+                if (digits() == 0)
+                {
+                    return false;
+                }
+            }
+
+            return i == length;
+        }
+
+        bool ReadHex4(const char* p, size_t remaining, UInt32& value)
+        {
+            if (remaining < 4)
+            {
+                return false;
+            }
+
+            value = 0;
+            for (size_t i = 0; i < 4; i++)
+            {
+                const char c = p[i];
+                UInt32 digit;
+
+                if (c >= '0' && c <= '9')
+                {
+                    digit = c - '0';
+                }
+                else if (c >= 'a' && c <= 'f')
+                {
+                    digit = c - 'a' + 10;
+                }
+                else if (c >= 'A' && c <= 'F')
+                {
+                    digit = c - 'A' + 10;
+                }
+                else
+                {
+                    return false;
+                }
+
+                value = (value << 4) | digit;
+            }
+
+            return true;
+        }
+
+        // String contents between the quotes: no raw control characters,
+        // and every backslash starts one of \" \\ \/ \b \f \n \r \t or \uXXXX
+        //
+        bool IsJsonStringBody(const char* p, size_t length)
+        {
+            size_t i = 0;
+
+            while (i < length)
+            {
+#if PAPYRUS_SSE2
+                // Skip blocks with nothing to check
+                for (; i + Simd::WIDTH <= length; i += Simd::WIDTH)
+                {
+                    const __m128i v = Simd::Load(p + i);
+                    if (Simd::Mask(_mm_or_si128(Simd::Equal(v, '\\'), Simd::InRange(v, 0x00, 0x1F))))
+                    {
+                        break;
+                    }
+                }
+                if (i >= length)
+                {
+                    break;
+                }
+#endif
+                const unsigned char c = static_cast<unsigned char>(p[i]);
+                if (c < 0x20)
+                {
+                    return false;
+                }
+
+                if (c != '\\')
+                {
+                    i++;
+                    continue;
+                }
+
+                if (i + 1 >= length)
+                {
+                    return false;
+                }
+
+                UInt32 codePoint;
+                switch (p[i + 1])
+                {
+                case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                    i += 2;
+                    break;
+                case 'u':
+                    if (!ReadHex4(p + i + 2, length - i - 2, codePoint))
+                    {
+                        return false;
+                    }
+                    i += 6;
+                    break;
+                default:
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void AppendUtf8(std::string& out, UInt32 codePoint)
+        {
+            if (codePoint < 0x80)
+            {
+                out.push_back(static_cast<char>(codePoint));
+            }
+            else if (codePoint < 0x800)
+            {
+                out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+                out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+            else if (codePoint < 0x10000)
+            {
+                out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+                out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+            else
+            {
+                out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+                out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+        }
+
+        // String contents with escapes resolved. \u escapes become UTF-8 and
+        // a lone surrogate becomes U+FFFD. The grammar pass has already
+        // rejected malformed escapes.
+        //
+        std::string DecodeString(const char* p, size_t length)
+        {
+            std::string result;
+            result.reserve(length);
+
+            for (size_t i = 0; i < length; i++)
+            {
+                if (p[i] != '\\' || i + 1 >= length)
+                {
+                    result.push_back(p[i]);
+                    continue;
+                }
+
+                const char escape = p[++i];
+                switch (escape)
+                {
+                case 'b': result.push_back('\b'); break;
+                case 'f': result.push_back('\f'); break;
+                case 'n': result.push_back('\n'); break;
+                case 'r': result.push_back('\r'); break;
+                case 't': result.push_back('\t'); break;
+                case 'u':
+                {
+                    UInt32 codePoint;
+                    if (!ReadHex4(p + i + 1, length - i - 1, codePoint))
+                    {
+                        result.append("\\u");
+                        break;
+                    }
+                    i += 4;
+
+                    // A high surrogate must be followed by an escaped low one
+                    if (codePoint >= 0xD800 && codePoint <= 0xDFFF)
+                    {
+                        UInt32 low;
+                        if (codePoint <= 0xDBFF && i + 2 < length && p[i + 1] == '\\' && p[i + 2] == 'u' &&
+                            ReadHex4(p + i + 3, length - i - 3, low) && low >= 0xDC00 && low <= 0xDFFF)
+                        {
+                            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                            i += 6;
+                        }
+                        else
+                        {
+                            codePoint = 0xFFFD;
+                        }
+                    }
+
+                    AppendUtf8(result, codePoint);
+                    break;
+                }
+                default:
+                    // \" \\ \/ and anything unknown: the character itself
+                    result.push_back(escape);
+                    break;
+                }
+            }
+
+            return result;
+        }
+
+        // FNV-1a, to find a cached document before comparing whole texts
+        //
+        UInt64 HashText(const std::string& text)
+        {
+            UInt64 hash = 14695981039346656037ull;
+            for (unsigned char c : text)
+            {
+                hash = (hash ^ c) * 1099511628211ull;
+            }
+            return hash;
+        }
+
+        struct CachedDocument
+        {
+            UInt64 hash;
+            std::shared_ptr<JsonDocument> document;
+            UInt64 lastUse;
+        };
+
+        std::mutex g_documentsLock;
+        std::vector<CachedDocument> g_documents;
+        UInt64 g_documentsClock = 0;
+    }
+
+    JsonDocument::JsonDocument(std::string text)
+        : m_text(std::move(text))
+    {
+        std::vector<UInt32> tokens;
+        size_t index = 0;
+
+        // Offsets are stored in 32 bits
+        m_valid = m_text.length() < JSON_NO_NODE &&
+                  IndexTokens(tokens) &&
+                  ParseValue(tokens, index, 0) &&
+                  index == tokens.size();
+
+        if (!m_valid)
+        {
+            m_tape.clear();
+        }
+    }
+
+    bool JsonDocument::IndexTokens(std::vector<UInt32>& tokens) const
+    {
+        const size_t length = m_text.length();
+
+        // State carried from one block into the next
+        bool escapeNext = false;
+        UInt32 insideString = 0;        // all lanes set while a string is open
+        UInt32 previousScalar = 0;      // 1 if the last lane was part of a bare value
+
+        for (size_t offset = 0; offset < length; offset += Simd::WIDTH)
+        {
+            // The final partial block is padded with whitespace
+            const char* block = m_text.data() + offset;
+            char padded[Simd::WIDTH];
+
+            if (length - offset < Simd::WIDTH)
+            {
+                memset(padded, ' ', sizeof(padded));
+                memcpy(padded, block, length - offset);
+                block = padded;
+            }
+
+            const BlockMasks masks = ClassifyBlock(block);
+
+            // A character right after an unescaped backslash is escaped
+            UInt32 escaped = 0;
+            if (masks.backslashes || escapeNext)
+            {
+                for (UInt32 i = 0; i < Simd::WIDTH; i++)
+                {
+                    if (escapeNext)
+                    {
+                        escaped |= 1u << i;
+                        escapeNext = false;
+                    }
+                    else if (masks.backslashes & (1u << i))
+                    {
+                        escapeNext = true;
+                    }
+                }
+            }
+
+            // Lanes inside a string: the opening quote is in, the closing quote is out
+            const UInt32 quotes = masks.quotes & ~escaped;
+            const UInt32 inside = PrefixXor(quotes) ^ insideString;
+            const UInt32 outside = ~inside & Simd::FULL_MASK;
+            insideString = (inside >> (Simd::WIDTH - 1)) ? Simd::FULL_MASK : 0;
+
+            // Bare values (numbers, true, false, null) are runs of anything else
+            const UInt32 scalars = outside & ~(masks.structurals | masks.whitespace | masks.quotes);
+            const UInt32 scalarStarts = scalars & ~((scalars << 1) | previousScalar);
+            previousScalar = scalars >> (Simd::WIDTH - 1);
+
+            for (UInt32 found = (masks.structurals & outside) | quotes | scalarStarts; found; found &= found - 1)
+            {
+                tokens.push_back(static_cast<UInt32>(offset + Simd::LowestLane(found)));
+            }
+        }
+
+        // An unterminated string swallows the rest of the text
+        return insideString == 0;
+    }
+
+    bool JsonDocument::ParseValue(const std::vector<UInt32>& tokens, size_t& index, UInt32 depth)
+    {
+        if (index >= tokens.size() || depth > MAX_JSON_DEPTH)
+        {
+            return false;
+        }
+
+        const UInt32 start = tokens[index];
+        const char first = m_text[start];
+
+        // m_tape grows while children are parsed, so the node is addressed by index
+        const UInt32 node = static_cast<UInt32>(m_tape.size());
+        m_tape.push_back(Node{ start, start, 0, kJson_Null });
+
+        if (first == '"')
+        {
+            // The closing quote is always the next token
+            if (index + 1 >= tokens.size())
+            {
+                return false;
+            }
+
+            m_tape[node].type = kJson_String;
+            m_tape[node].start = start + 1;
+            m_tape[node].end = tokens[index + 1];
+
+            if (!IsJsonStringBody(m_text.data() + start + 1, tokens[index + 1] - start - 1))
+            {
+                return false;
+            }
+            index += 2;
+        }
+        else if (first == '{' || first == '[')
+        {
+            const bool isObject = first == '{';
+            const char close = isObject ? '}' : ']';
+            m_tape[node].type = isObject ? kJson_Object : kJson_Array;
+            index++;
+
+            // Members until the closing bracket; an empty container has none
+            if (index < tokens.size() && m_text[tokens[index]] != close)
+            {
+                for (;;)
+                {
+                    if (isObject)
+                    {
+                        // "key" :
+                        if (index >= tokens.size() || m_text[tokens[index]] != '"' || !ParseValue(tokens, index, depth + 1))
+                        {
+                            return false;
+                        }
+                        if (index >= tokens.size() || m_text[tokens[index]] != ':')
+                        {
+                            return false;
+                        }
+                        index++;
+                    }
+
+                    if (!ParseValue(tokens, index, depth + 1) || index >= tokens.size())
+                    {
+                        return false;
+                    }
+
+                    const char separator = m_text[tokens[index]];
+                    if (separator == close)
+                    {
+                        break;
+                    }
+                    if (separator != ',')
+                    {
+                        return false;
+                    }
+                    index++;
+                }
+            }
+
+            if (index >= tokens.size())
+            {
+                return false;
+            }
+
+            m_tape[node].end = tokens[index] + 1;
+            index++;
+        }
+        else if (IsJsonStructural(first))
+        {
+            return false;
+        }
+        else
+        {
+            // A bare value runs to the next token or whitespace
+            const size_t limit = index + 1 < tokens.size() ? tokens[index + 1] : m_text.length();
+            size_t end = start;
+            while (end < limit && !IsJsonWhitespace(m_text[end]))
+            {
+                end++;
+            }
+
+            const char* value = m_text.data() + start;
+            const size_t length = end - start;
+
+            if (length == 4 && memcmp(value, "true", 4) == 0)
+            {
+                m_tape[node].type = kJson_True;
+            }
+            else if (length == 5 && memcmp(value, "false", 5) == 0)
+            {
+                m_tape[node].type = kJson_False;
+            }
+            else if (length == 4 && memcmp(value, "null", 4) == 0)
+            {
+                m_tape[node].type = kJson_Null;
+            }
+            else if (IsJsonNumber(value, length))
+            {
+                m_tape[node].type = kJson_Number;
+            }
+            else
+            {
+                return false;
+            }
+
+            m_tape[node].end = static_cast<UInt32>(end);
+            index++;
+        }
+
+        m_tape[node].next = static_cast<UInt32>(m_tape.size());
+        return true;
+    }
+
+    bool JsonDocument::KeyEquals(UInt32 node, const char* key, size_t keyLength) const
+    {
+        const char* raw = m_text.data() + m_tape[node].start;
+        size_t length = m_tape[node].end - m_tape[node].start;
+
+        // Most keys have no escapes and compare in place
+        std::string decoded;
+        if (memchr(raw, '\\', length))
+        {
+            decoded = DecodeString(raw, length);
+            raw = decoded.data();
+            length = decoded.length();
+        }
+
+        if (length != keyLength)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < length; i++)
+        {
+            if (std::tolower(static_cast<unsigned char>(raw[i])) != std::tolower(static_cast<unsigned char>(key[i])))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    UInt32 JsonDocument::Find(const std::string& path) const
+    {
+        if (!m_valid)
+        {
+            return JSON_NO_NODE;
+        }
+
+        UInt32 node = 0;
+        size_t i = 0;
+
+        while (i < path.length())
+        {
+            if (path[i] == '.')
+            {
+                i++;
+                continue;
+            }
+
+            if (path[i] == '[')
+            {
+                // [n] steps over n elements of an array
+                UInt32 position = 0;
+                size_t digits = 0;
+
+                for (i++; i < path.length() && path[i] >= '0' && path[i] <= '9'; i++, digits++)
+                {
+                    position = position * 10 + (path[i] - '0');
+                    if (position > m_tape.size())
+                    {
+                        return JSON_NO_NODE;
+                    }
+                }
+
+                if (digits == 0 || i >= path.length() || path[i] != ']' || m_tape[node].type != kJson_Array)
+                {
+                    return JSON_NO_NODE;
+                }
+                i++;
+
+                UInt32 child = node + 1;
+                for (; position > 0 && child < m_tape[node].next; position--)
+                {
+                    child = m_tape[child].next;
+                }
+
+                if (child >= m_tape[node].next)
+                {
+                    return JSON_NO_NODE;
+                }
+
+                node = child;
+                continue;
+            }
+
+            // A key runs to the next '.' or '['
+            const size_t keyStart = i;
+            while (i < path.length() && path[i] != '.' && path[i] != '[')
+            {
+                i++;
+            }
+
+            if (m_tape[node].type != kJson_Object)
+            {
+                return JSON_NO_NODE;
+            }
+
+            // Members are key nodes each followed by their value's subtree
+            UInt32 found = JSON_NO_NODE;
+            for (UInt32 key = node + 1; key < m_tape[node].next; key = m_tape[key + 1].next)
+            {
+                if (KeyEquals(key, path.data() + keyStart, i - keyStart))
+                {
+                    found = key + 1;
+                    break;
+                }
+            }
+
+            if (found == JSON_NO_NODE)
+            {
+                return JSON_NO_NODE;
+            }
+
+            node = found;
+        }
+
+        return node;
+    }
+
+    std::string JsonDocument::AsString(UInt32 node) const
+    {
+        const Node& value = m_tape[node];
+        const char* raw = m_text.data() + value.start;
+
+        switch (value.type)
+        {
+        case kJson_String:
+            return DecodeString(raw, value.end - value.start);
+        case kJson_Null:
+            return std::string();
+        default:
+            return std::string(raw, value.end - value.start);
+        }
+    }
+
+    bool JsonDocument::AsNumber(UInt32 node, double& value) const
+    {
+        switch (m_tape[node].type)
+        {
+        case kJson_Number:
+        {
+            // strtod needs a terminator the shared text does not have here
+            const std::string number(m_text.data() + m_tape[node].start, m_tape[node].end - m_tape[node].start);
+            value = strtod(number.c_str(), nullptr);
+            return true;
+        }
+        case kJson_True:
+            value = 1.0;
+            return true;
+        case kJson_False:
+            value = 0.0;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    std::vector<std::string> JsonDocument::Elements(UInt32 node, size_t maxLength) const
+    {
+        std::vector<std::string> result;
+        const JsonType type = m_tape[node].type;
+
+        if (type != kJson_Array && type != kJson_Object)
+        {
+            return result;
+        }
+
+        for (UInt32 child = node + 1; child < m_tape[node].next; child = m_tape[child].next)
+        {
+            // Skip over each member's key to its value
+            if (type == kJson_Object)
+            {
+                child++;
+            }
+
+            if (ByteLength(child) <= maxLength)
+            {
+                result.push_back(AsString(child));
+            }
+        }
+
+        return result;
+    }
+
+    std::shared_ptr<JsonDocument> ParseJson(std::string text)
+    {
+        const UInt64 hash = HashText(text);
+
+        {
+            std::lock_guard<std::mutex> lock(g_documentsLock);
+
+            for (CachedDocument& entry : g_documents)
+            {
+                if (entry.hash == hash && entry.document->Text() == text)
+                {
+                    entry.lastUse = ++g_documentsClock;
+                    return entry.document;
+                }
+            }
+        }
+
+        // Parse outside the lock; a racing parse of the same text only costs time
+        std::shared_ptr<JsonDocument> document = std::make_shared<JsonDocument>(std::move(text));
+        if (!document->IsValid())
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(g_documentsLock);
+
+        // A free slot, or the least recently used one
+        if (g_documents.size() < JSON_CACHE_ENTRIES)
+        {
+            g_documents.push_back(CachedDocument{ hash, document, ++g_documentsClock });
+            return document;
+        }
+
+        CachedDocument* oldest = &g_documents[0];
+        for (CachedDocument& entry : g_documents)
+        {
+            if (entry.lastUse < oldest->lastUse)
+            {
+                oldest = &entry;
+            }
+        }
+
+        *oldest = CachedDocument{ hash, document, ++g_documentsClock };
+        return document;
+    }
+}
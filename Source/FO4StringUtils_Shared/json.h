@@ -0,0 +1,103 @@
+#pragma once
+
+// ==============
+// JSON Documents
+// ==============
+
+#include <memory>                           // for std::shared_ptr
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+namespace Papyrus
+{
+    // Deeper nesting than this fails to parse rather than exhausting the stack
+    constexpr UInt32 MAX_JSON_DEPTH = 256;
+
+    // Recently parsed texts kept for reuse when the same content comes back
+    constexpr size_t JSON_CACHE_ENTRIES = 8;
+
+    // Returned by JsonDocument::Find when a path does not lead to a value
+    constexpr UInt32 JSON_NO_NODE = 0xFFFFFFFF;
+
+    // Values of the Papyrus JsonGetType result; keep in sync with FO4StringUtils.psc
+    enum JsonType : UInt8
+    {
+        kJson_Null = 0,
+        kJson_False = 1,
+        kJson_True = 2,
+        kJson_Number = 3,
+        kJson_String = 4,
+        kJson_Array = 5,
+        kJson_Object = 6,
+    };
+
+    // A parsed, read-only JSON text.
+    //
+    // The first pass classifies 16 bytes at a time and records where every
+    // bracket, colon, comma, quote and bare value starts, skipping anything
+    // inside strings. The second pass checks the grammar over just those
+    // positions, along with the escapes and characters of each string, and
+    // builds the tape: one node per value with its byte range and the index
+    // of the node after its subtree, so a lookup steps over siblings without
+    // descending into them. Strings and numbers stay as byte ranges until a
+    // getter asks for them.
+    //
+    class JsonDocument
+    {
+    public:
+        explicit JsonDocument(std::string text);
+
+        bool IsValid() const { return m_valid; }
+
+        const std::string& Text() const { return m_text; }
+
+        // Usage: UInt32 node = doc.Find("items[2].name");
+        //
+        // An empty path is the root value. Object keys match without regard
+        // to case, as the Papyrus string cache may have changed it.
+        //
+        UInt32 Find(const std::string& path) const;
+
+        JsonType Type(UInt32 node) const { return m_tape[node].type; }
+
+        // Bytes of source text the value spans, escapes and brackets
+        // included; never less than the length of AsString
+        size_t ByteLength(UInt32 node) const { return m_tape[node].end - m_tape[node].start; }
+
+        // Decoded text of a string; numbers and literals give their source
+        // text, arrays and objects their raw JSON, and null an empty string
+        //
+        std::string AsString(UInt32 node) const;
+
+        // Numbers and booleans (true is 1); false for every other type
+        //
+        bool AsNumber(UInt32 node, double& value) const;
+
+        // AsString of each array element or object member value. Values
+        // whose ByteLength is over maxLength are left out.
+        //
+        std::vector<std::string> Elements(UInt32 node, size_t maxLength) const;
+
+    private:
+        struct Node
+        {
+            UInt32 start;       // first byte; for strings, the byte after the opening quote
+            UInt32 end;         // one past the last byte; for strings, the closing quote
+            UInt32 next;        // tape index just past this node's subtree
+            JsonType type;
+        };
+
+        bool IndexTokens(std::vector<UInt32>& tokens) const;
+        bool ParseValue(const std::vector<UInt32>& tokens, size_t& index, UInt32 depth);
+        bool KeyEquals(UInt32 node, const char* key, size_t keyLength) const;
+
+        std::string m_text;
+        std::vector<Node> m_tape;
+        bool m_valid = false;
+    };
+
+    // Returns nullptr if text is not valid JSON. A text parsed recently is
+    // not parsed again; both callers share one document.
+    //
+    std::shared_ptr<JsonDocument> ParseJson(std::string text);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+// ============
+// SIMD Helpers
+// ============
+
+// SSE2 is part of every x64 CPU, so the plugin builds always have it. Other
+// targets (or a compiler without SSE2 enabled) get PAPYRUS_SSE2 0 and every
+// caller keeps a scalar path for that case.
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define PAPYRUS_SSE2 1
+#include <emmintrin.h>                      // for SSE2 intrinsics
+#else
+#define PAPYRUS_SSE2 0
+#endif
+
+#include <cstddef>                          // for size_t
+
+#ifdef _MSC_VER
+#include <intrin.h>                         // for _BitScanForward, _BitScanReverse
+#endif
+
+namespace Papyrus
+{
+    namespace Simd
+    {
+        // Bytes per vector
+        constexpr size_t WIDTH = 16;
+
+        // All lanes set in a Mask() result
+        constexpr UInt32 FULL_MASK = 0xFFFF;
+
+        // Lane of the lowest set bit; mask must not be 0
+        //
+        inline UInt32 LowestLane(UInt32 mask)
+        {
+#ifdef _MSC_VER
+            unsigned long lane;
+            _BitScanForward(&lane, mask);
+            return static_cast<UInt32>(lane);
+#else
+            return static_cast<UInt32>(__builtin_ctz(mask));
+#endif
+        }
+
+        // Lane of the highest set bit; mask must not be 0
+        //
+        inline UInt32 HighestLane(UInt32 mask)
+        {
+#ifdef _MSC_VER
+            unsigned long lane;
+            _BitScanReverse(&lane, mask);
+            return static_cast<UInt32>(lane);
+#else
+            return static_cast<UInt32>(31 - __builtin_clz(mask));
+#endif
+        }
+
+#if PAPYRUS_SSE2
+        inline __m128i Load(const char* p)
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        inline void Store(char* p, __m128i v)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+        }
+
+        inline __m128i Splat(char c)
+        {
+            return _mm_set1_epi8(c);
+        }
+
+        // Lanes equal to c
+        //
+        inline __m128i Equal(__m128i v, char c)
+        {
+            return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+        }
+
+        // Lanes with lo <= byte <= hi, for bounds in 0..126. The compare is
+        // signed, so bytes 0x80 and up are negative and never match.
+        //
+        inline __m128i InRange(__m128i v, char lo, char hi)
+        {
+            return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                                 _mm_cmplt_epi8(v, _mm_set1_epi8(static_cast<char>(hi + 1))));
+        }
+
+        // Lanes below 0x80
+        //
+        inline __m128i IsASCII(__m128i v)
+        {
+            return _mm_cmpgt_epi8(v, _mm_set1_epi8(-1));
+        }
+
+        // One bit per lane, lane 0 in bit 0
+        //
+        inline UInt32 Mask(__m128i v)
+        {
+            return static_cast<UInt32>(_mm_movemask_epi8(v));
+        }
+#endif
+    }
+}
@@ -0,0 +1,140 @@
+// =======================
+// Per-Thread Source Cache
+// =======================
+
+#include "charclass.h"                      // for IsAllOfClass
+#include "functions.h"                      // for ToLowerCopy
+#include "sourcecache.h"                    // for CachedSource
+
+namespace Papyrus
+{
+    namespace
+    {
+        struct SourceCache
+        {
+            std::unique_ptr<CachedSource> entries[SOURCE_CACHE_ENTRIES];
+            UInt64 clock = 0;
+        };
+
+        // Leaked on purpose like the stats counters: releasing cached strings
+        // during thread teardown could run after the game's string cache is gone
+        thread_local SourceCache* t_sourceCache = nullptr;
+    }
+
+    CachedSource::CachedSource(const BSFixedString& sourceBS)
+        : m_source(sourceBS)
+    {
+        const char* str = sourceBS.c_str();
+        if (str)
+        {
+            m_raw = str;
+        }
+    }
+
+    const std::string& CachedSource::Folded()
+    {
+        if (!m_hasFolded)
+        {
+            m_folded = ToLowerCopy(m_raw);
+            m_hasFolded = true;
+        }
+
+        return m_folded;
+    }
+
+    bool CachedSource::IsAllOf(UInt16 charClass)
+    {
+        if ((m_classesKnown & charClass) == 0)
+        {
+            if (IsAllOfClass(m_raw.data(), m_raw.size(), charClass))
+            {
+                m_classesHeld |= charClass;
+            }
+            m_classesKnown |= charClass;
+        }
+
+        return (m_classesHeld & charClass) != 0;
+    }
+
+    const Utf8Index& CachedSource::Utf8()
+    {
+        if (!m_utf8)
+        {
+            m_utf8.reset(new Utf8Index(m_raw.data(), m_raw.size()));
+        }
+
+        return *m_utf8;
+    }
+
+    const std::vector<TokenSpan>& CachedSource::Tokens(const BSFixedString& delimiterBS)
+    {
+        if (!m_hasTokens || m_tokenDelimiter.data != delimiterBS.data)
+        {
+            const char* delimiter = delimiterBS.c_str();
+
+            m_tokens.clear();
+            SplitLiteralSpans(m_raw.data(), m_raw.size(), delimiter ? delimiter : "", m_tokens);
+            m_tokenDelimiter = delimiterBS;
+            m_hasTokens = true;
+        }
+
+        return m_tokens;
+    }
+
+    CachedSource& CachedSourceFor(const BSFixedString& sourceBS)
+    {
+        if (!t_sourceCache)
+        {
+            t_sourceCache = new SourceCache();
+        }
+
+        SourceCache& cache = *t_sourceCache;
+        const UInt64 now = ++cache.clock;
+
+        // Interned strings with the same text share one entry pointer
+        std::unique_ptr<CachedSource>* oldest = &cache.entries[0];
+        for (auto& entry : cache.entries)
+        {
+            if (!entry)
+            {
+                oldest = &entry;
+                continue;
+            }
+
+            if (entry->m_source.data == sourceBS.data)
+            {
+                entry->m_lastUse = now;
+                return *entry;
+            }
+
+            if (*oldest && entry->m_lastUse < (*oldest)->m_lastUse)
+            {
+                oldest = &entry;
+            }
+        }
+
+        // Replace the least recently used entry, never one used since
+        oldest->reset(new CachedSource(sourceBS));
+        (*oldest)->m_lastUse = now;
+        return **oldest;
+    }
+
+    CachedSource* FindCachedSource(const BSFixedString& sourceBS)
+    {
+        if (!t_sourceCache)
+        {
+            return nullptr;
+        }
+
+        for (auto& entry : t_sourceCache->entries)
+        {
+            if (entry && entry->m_source.data == sourceBS.data)
+            {
+                entry->m_lastUse = ++t_sourceCache->clock;
+                return entry.get();
+            }
+        }
+
+        return nullptr;
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+// =======================
+// Per-Thread Source Cache
+// =======================
+
+// F4SE
+#include "f4se/PapyrusNativeFunctions.h"    // for BSFixedString
+
+#include <memory>                           // for std::unique_ptr
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+#include "tokenize.h"                       // for TokenSpan
+#include "utf8.h"                           // for Utf8Index
+
+namespace Papyrus
+{
+    // Sources remembered per VM thread. A native may hold this many
+    // CachedSource references at once without one evicting another.
+    constexpr size_t SOURCE_CACHE_ENTRIES = 4;
+
+    // A script string prepared for the natives. The raw copy is made when the
+    // entry is filled; folded text, class checks and the UTF-8 index are
+    // built the first time a native asks for them.
+    //
+    // The BSFixedString reference keeps the interned entry alive, so its
+    // address cannot be recycled for different text while it is cached.
+    //
+    class CachedSource
+    {
+    public:
+        explicit CachedSource(const BSFixedString& sourceBS);
+
+        // The text as FromBSFixedString would return it
+        const std::string& Raw() const { return m_raw; }
+
+        size_t Length() const { return m_raw.size(); }
+
+        // Lowercase copy, as NormalizeForSearch would return it
+        const std::string& Folded();
+
+        // IsAllOfClass over the text for one kCharClass_ bit, remembered per
+        // class so asking again does not rescan
+        bool IsAllOf(UInt16 charClass);
+
+        const Utf8Index& Utf8();
+
+        // Where each token starts and ends when the text is cut at
+        // delimiter, as Split would cut it. Only the table for the last
+        // delimiter asked for is kept; it is found again by the delimiter's
+        // interned pointer, so a loop over TokenAt never rescans the text.
+        //
+        const std::vector<TokenSpan>& Tokens(const BSFixedString& delimiterBS);
+
+    private:
+        friend CachedSource& CachedSourceFor(const BSFixedString& sourceBS);
+        friend CachedSource* FindCachedSource(const BSFixedString& sourceBS);
+
+        BSFixedString m_source;
+        std::string m_raw;
+
+        std::string m_folded;
+        bool m_hasFolded = false;
+
+        UInt16 m_classesKnown = 0;          // classes IsAllOf has answered
+        UInt16 m_classesHeld = 0;           // of those, the ones every character is in
+
+        std::unique_ptr<Utf8Index> m_utf8;
+
+        BSFixedString m_tokenDelimiter;     // held so its address cannot be reused for other text
+        std::vector<TokenSpan> m_tokens;
+        bool m_hasTokens = false;
+
+        UInt64 m_lastUse = 0;
+    };
+
+    // Usage: const std::string& sourceStr = CachedSourceFor(sourceBS).Folded();
+    //
+    // The reference stays valid until this thread looks up
+    // SOURCE_CACHE_ENTRIES other strings.
+    //
+    CachedSource& CachedSourceFor(const BSFixedString& sourceBS);
+
+    // The entry for sourceBS if this thread already has one, else nullptr.
+    // For natives that can read the interned text in place and should not
+    // copy it just to look at it once.
+    //
+    CachedSource* FindCachedSource(const BSFixedString& sourceBS);
+}
@@ -0,0 +1,348 @@
+// ======================
+// Native Call Statistics
+// ======================
+
+#include <algorithm>                        // for std::sort
+#include <atomic>                           // for std::atomic
+#include <chrono>                           // for std::chrono::steady_clock
+#include <cstdio>                           // for snprintf
+#include <mutex>                            // for std::mutex
+#include <thread>                           // for std::thread
+#include <vector>                           // for std::vector
+
+#include "functions.h"                      // for PAPYRUS_CLASS_NAME
+#include "stats.h"                          // for Stats
+
+namespace Papyrus
+{
+    namespace Stats
+    {
+        namespace
+        {
+            // Counters for one native on one thread. Only the owning thread
+            // writes, so plain load/store is enough and no lock prefix is paid.
+            struct FunctionCounters
+            {
+                std::atomic<UInt64> calls;
+                std::atomic<UInt64> bytesIn;
+                std::atomic<UInt64> bytesOut;
+                std::atomic<UInt64> ticks;
+                std::atomic<UInt64> maxTicks;
+                std::atomic<UInt32> histogram[HISTOGRAM_BUCKETS];
+            };
+
+            struct ThreadCounters
+            {
+                FunctionCounters functions[MAX_FUNCTIONS];
+            };
+
+            // Plain snapshot of counters, summed across threads
+            struct Totals
+            {
+                UInt64 calls = 0;
+                UInt64 bytesIn = 0;
+                UInt64 bytesOut = 0;
+                UInt64 ticks = 0;
+                UInt64 maxTicks = 0;
+                UInt64 histogram[HISTOGRAM_BUCKETS] = {};
+            };
+
+            const char* g_names[MAX_FUNCTIONS] = {};
+            std::atomic<UInt32> g_functionCount(0);
+
+            // Every thread that has recorded a call; never shrinks
+            std::mutex g_threadsLock;
+            std::vector<ThreadCounters*> g_threads;
+
+            // Totals at the last Reset, subtracted when reporting
+            std::vector<Totals> g_baseline(MAX_FUNCTIONS);
+
+            double g_ticksPerMicrosecond = 1000.0;
+
+            // Counters are leaked on purpose: they must outlive the thread so
+            // its calls stay in the totals, and VM threads live for the session
+            thread_local ThreadCounters* t_counters = nullptr;
+
+            inline void Bump(std::atomic<UInt64>& counter, UInt64 amount)
+            {
+                counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+            }
+
+            inline UInt32 HighestBit(UInt64 value)
+            {
+                UInt32 bit = 0;
+                while (value >>= 1)
+                {
+                    bit++;
+                }
+                return bit;
+            }
+
+            // Values below 4 get their own bucket, above that each power of
+            // two is split into HISTOGRAM_SUB_BUCKETS linear steps
+            //
+            inline UInt32 HistogramBucket(UInt64 ticks)
+            {
+                if (ticks < HISTOGRAM_SUB_BUCKETS)
+                {
+                    return static_cast<UInt32>(ticks);
+                }
+
+                const UInt32 magnitude = HighestBit(ticks);
+                const UInt32 sub = static_cast<UInt32>(ticks >> (magnitude - 2)) & (HISTOGRAM_SUB_BUCKETS - 1);
+                const UInt32 bucket = (magnitude - 1) * HISTOGRAM_SUB_BUCKETS + sub;
+
+                return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+            }
+
+            // Smallest tick count that lands in the bucket
+            //
+            inline UInt64 HistogramBucketFloor(UInt32 bucket)
+            {
+                if (bucket < HISTOGRAM_SUB_BUCKETS)
+                {
+                    return bucket;
+                }
+
+                const UInt32 magnitude = bucket / HISTOGRAM_SUB_BUCKETS + 1;
+                const UInt64 sub = bucket % HISTOGRAM_SUB_BUCKETS;
+                return (HISTOGRAM_SUB_BUCKETS + sub) << (magnitude - 2);
+            }
+
+            ThreadCounters* CountersForThisThread()
+            {
+                if (!t_counters)
+                {
+                    t_counters = new ThreadCounters();
+
+                    std::lock_guard<std::mutex> lock(g_threadsLock);
+                    g_threads.push_back(t_counters);
+                }
+                return t_counters;
+            }
+
+            // Caller must hold g_threadsLock
+            //
+            std::vector<Totals> Collect()
+            {
+                const UInt32 count = g_functionCount.load();
+                std::vector<Totals> totals(count);
+
+                for (ThreadCounters* thread : g_threads)
+                {
+                    for (UInt32 id = 0; id < count; ++id)
+                    {
+                        const FunctionCounters& c = thread->functions[id];
+                        Totals& t = totals[id];
+
+                        t.calls += c.calls.load(std::memory_order_relaxed);
+                        t.bytesIn += c.bytesIn.load(std::memory_order_relaxed);
+                        t.bytesOut += c.bytesOut.load(std::memory_order_relaxed);
+                        t.ticks += c.ticks.load(std::memory_order_relaxed);
+                        t.maxTicks = std::max(t.maxTicks, c.maxTicks.load(std::memory_order_relaxed));
+
+                        for (UInt32 b = 0; b < HISTOGRAM_BUCKETS; ++b)
+                        {
+                            t.histogram[b] += c.histogram[b].load(std::memory_order_relaxed);
+                        }
+                    }
+                }
+
+                return totals;
+            }
+
+            UInt64 Percentile(const Totals& t, double fraction)
+            {
+                const UInt64 target = static_cast<UInt64>(t.calls * fraction);
+                UInt64 seen = 0;
+
+                for (UInt32 b = 0; b < HISTOGRAM_BUCKETS; ++b)
+                {
+                    seen += t.histogram[b];
+                    if (seen > target)
+                    {
+                        return HistogramBucketFloor(b);
+                    }
+                }
+                return t.maxTicks;
+            }
+
+            double ToMicroseconds(UInt64 ticks)
+            {
+                return ticks / g_ticksPerMicrosecond;
+            }
+
+            // Writes the report to the plugin log every interval, away from
+            // the VM threads so no script call pays for formatting it
+            //
+            void DumpLoop(UInt32 intervalSeconds)
+            {
+                for (;;)
+                {
+                    std::this_thread::sleep_for(std::chrono::seconds(intervalSeconds));
+                    _MESSAGE("%s native call statistics:\n%s", PAPYRUS_CLASS_NAME, Report().c_str());
+                }
+            }
+        }
+
+        // Measure the TSC against the OS clock so ticks can be shown as time
+        //
+        void CalibrateTicks()
+        {
+            const auto startTime = std::chrono::steady_clock::now();
+            const UInt64 startTicks = Now();
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            const UInt64 elapsedTicks = Now() - startTicks;
+            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+            if (elapsed > 0 && elapsedTicks > 0)
+            {
+                g_ticksPerMicrosecond = static_cast<double>(elapsedTicks) / elapsed;
+            }
+        }
+
+        void Start(UInt32 dumpIntervalSeconds)
+        {
+            // Detached like the async workers; it lives for the session
+            if (dumpIntervalSeconds > 0)
+            {
+                std::thread(DumpLoop, dumpIntervalSeconds).detach();
+            }
+
+            _MESSAGE("%s stats enabled, %.0f ticks/us, dump every %us", PAPYRUS_CLASS_NAME, g_ticksPerMicrosecond, dumpIntervalSeconds);
+        }
+
+        UInt32 RegisterFunction(const char* name)
+        {
+            const UInt32 id = g_functionCount.load();
+
+            // Out of slots: Record ignores ids past the end
+            if (id >= MAX_FUNCTIONS)
+            {
+                return MAX_FUNCTIONS;
+            }
+
+            g_names[id] = name;
+            g_functionCount.store(id + 1);
+            return id;
+        }
+
+        void Record(UInt32 id, UInt64 ticks, UInt64 bytesIn, UInt64 bytesOut)
+        {
+            if (id >= MAX_FUNCTIONS)
+            {
+                return;
+            }
+
+            FunctionCounters& c = CountersForThisThread()->functions[id];
+
+            Bump(c.calls, 1);
+            Bump(c.bytesIn, bytesIn);
+            Bump(c.bytesOut, bytesOut);
+            Bump(c.ticks, ticks);
+
+            if (ticks > c.maxTicks.load(std::memory_order_relaxed))
+            {
+                c.maxTicks.store(ticks, std::memory_order_relaxed);
+            }
+
+            std::atomic<UInt32>& bucket = c.histogram[HistogramBucket(ticks)];
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        std::string Report()
+        {
+            std::vector<Totals> totals;
+            {
+                std::lock_guard<std::mutex> lock(g_threadsLock);
+                totals = Collect();
+
+                // Show only what happened since the last Reset
+                for (size_t id = 0; id < totals.size(); ++id)
+                {
+                    Totals& t = totals[id];
+                    const Totals& base = g_baseline[id];
+
+                    t.calls -= base.calls;
+                    t.bytesIn -= base.bytesIn;
+                    t.bytesOut -= base.bytesOut;
+                    t.ticks -= base.ticks;
+                    for (UInt32 b = 0; b < HISTOGRAM_BUCKETS; ++b)
+                    {
+                        t.histogram[b] -= base.histogram[b];
+                    }
+
+                    // The exact max cannot be un-merged, so after a Reset fall
+                    // back to the floor of the slowest bucket still occupied
+                    if (base.calls > 0)
+                    {
+                        t.maxTicks = 0;
+                        for (UInt32 b = 0; b < HISTOGRAM_BUCKETS; ++b)
+                        {
+                            if (t.histogram[b] > 0)
+                            {
+                                t.maxTicks = HistogramBucketFloor(b);
+                            }
+                        }
+                    }
+                }
+            }
+
+            // Most expensive natives first
+            std::vector<UInt32> order;
+            for (UInt32 id = 0; id < totals.size(); ++id)
+            {
+                if (totals[id].calls > 0)
+                {
+                    order.push_back(id);
+                }
+            }
+            std::sort(order.begin(), order.end(), [&totals](UInt32 a, UInt32 b)
+            {
+                return totals[a].ticks > totals[b].ticks;
+            });
+
+            std::string report;
+            char line[256];
+
+            for (UInt32 id : order)
+            {
+                const Totals& t = totals[id];
+                snprintf(line, sizeof(line), "%s calls=%llu in=%llu out=%llu total=%.1fus avg=%.2fus p50=%.2fus p90=%.2fus p99=%.2fus max=%.2fus\n",
+                    g_names[id],
+                    static_cast<unsigned long long>(t.calls),
+                    static_cast<unsigned long long>(t.bytesIn),
+                    static_cast<unsigned long long>(t.bytesOut),
+                    ToMicroseconds(t.ticks),
+                    ToMicroseconds(t.ticks) / t.calls,
+                    ToMicroseconds(Percentile(t, 0.50)),
+                    ToMicroseconds(Percentile(t, 0.90)),
+                    ToMicroseconds(Percentile(t, 0.99)),
+                    ToMicroseconds(t.maxTicks));
+                report += line;
+            }
+
+            return report;
+        }
+
+        const char* FunctionName(UInt32 id)
+        {
+            return id < g_functionCount.load() ? g_names[id] : "?";
+        }
+
+        double TicksPerMicrosecond()
+        {
+            return g_ticksPerMicrosecond;
+        }
+
+        void Reset()
+        {
+            std::lock_guard<std::mutex> lock(g_threadsLock);
+
+            std::vector<Totals> totals = Collect();
+            std::copy(totals.begin(), totals.end(), g_baseline.begin());
+        }
+    }
+}
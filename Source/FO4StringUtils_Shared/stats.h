@@ -0,0 +1,64 @@
+#pragma once
+
+// ========================
+// Native Call Statistics
+// ========================
+
+#include <string>                           // for std::string
+
+#ifdef _MSC_VER
+#include <intrin.h>                         // for __rdtsc
+#else
+#include <x86intrin.h>                      // for __rdtsc
+#endif
+
+namespace Papyrus
+{
+    namespace Stats
+    {
+        // Upper bound on distinct natives that can be tracked
+        constexpr UInt32 MAX_FUNCTIONS = 256;
+
+        // Log-linear latency buckets: 4 per power of two up to 2^40 ticks
+        constexpr UInt32 HISTOGRAM_SUB_BUCKETS = 4;
+        constexpr UInt32 HISTOGRAM_BUCKETS = 160;
+
+        // Measure the TSC rate against the OS clock; blocks for ~20ms
+        //
+        void CalibrateTicks();
+
+        // Start writing the report to the log every dumpIntervalSeconds,
+        // from a thread of its own (0 = never)
+        //
+        void Start(UInt32 dumpIntervalSeconds);
+
+        // Returns an id for Record, called once per native at registration
+        //
+        UInt32 RegisterFunction(const char* name);
+
+        // Add one call to the calling thread's counters
+        //
+        void Record(UInt32 id, UInt64 ticks, UInt64 bytesIn, UInt64 bytesOut);
+
+        // One line per called native, slowest total time first
+        //
+        std::string Report();
+
+        // Zero all counters as seen by Report
+        //
+        void Reset();
+
+        // Name given to RegisterFunction, or "?" for an unknown id
+        //
+        const char* FunctionName(UInt32 id);
+
+        // Measured by CalibrateTicks, defaults to a 1 GHz guess before that
+        //
+        double TicksPerMicrosecond();
+
+        inline UInt64 Now()
+        {
+            return __rdtsc();
+        }
+    }
+}
@@ -0,0 +1,130 @@
+// ========================
+// Case-Folded String Sets
+// ========================
+
+#include <cctype>                           // for std::tolower
+
+#include "stringset.h"                      // for FoldedStringSet
+
+namespace Papyrus
+{
+    namespace
+    {
+        constexpr UInt32 EMPTY_SLOT = 0xFFFFFFFF;
+
+        // std::tolower for every byte, as ToLowerCopy folds
+        struct FoldTable
+        {
+            char lower[256];
+
+            FoldTable()
+            {
+                for (int i = 0; i < 256; i++)
+                {
+                    lower[i] = static_cast<char>(std::tolower(i));
+                }
+            }
+        };
+
+        const FoldTable g_fold;
+
+        inline char Fold(char c)
+        {
+            return g_fold.lower[static_cast<unsigned char>(c)];
+        }
+
+        // FNV-1a over the folded bytes; also measures the string
+        //
+        inline UInt32 FoldedHash(const char* text, size_t& length)
+        {
+            UInt32 hash = 2166136261u;
+            const char* p = text;
+            for (; *p; p++)
+            {
+                hash = (hash ^ static_cast<unsigned char>(Fold(*p))) * 16777619u;
+            }
+
+            length = p - text;
+            return hash;
+        }
+    }
+
+    FoldedStringSet::FoldedStringSet(size_t expected)
+    {
+        // At most half full, so probe runs stay short
+        size_t capacity = 16;
+        while (capacity < expected * 2)
+        {
+            capacity *= 2;
+        }
+
+        m_slots.assign(capacity, EMPTY_SLOT);
+        m_entries.reserve(expected);
+        m_mask = capacity - 1;
+    }
+
+    size_t FoldedStringSet::Probe(const char* text, size_t length, UInt32 hash, const void* identity) const
+    {
+        for (size_t slot = hash & m_mask;; slot = (slot + 1) & m_mask)
+        {
+            const UInt32 index = m_slots[slot];
+            if (index == EMPTY_SLOT)
+            {
+                return slot;
+            }
+
+            const Entry& entry = m_entries[index];
+
+            // The same interned entry is the same text
+            if (identity && entry.identity == identity)
+            {
+                return slot;
+            }
+
+            if (entry.hash != hash || entry.length != length)
+            {
+                continue;
+            }
+
+            const char* key = m_keys.data() + entry.offset;
+            size_t i = 0;
+            while (i < length && key[i] == Fold(text[i]))
+            {
+                i++;
+            }
+            if (i == length)
+            {
+                return slot;
+            }
+        }
+    }
+
+    bool FoldedStringSet::Insert(const char* text, const void* identity)
+    {
+        size_t length;
+        const UInt32 hash = FoldedHash(text, length);
+        const size_t slot = Probe(text, length, hash, identity);
+
+        if (m_slots[slot] != EMPTY_SLOT)
+        {
+            return false;
+        }
+
+        m_slots[slot] = static_cast<UInt32>(m_entries.size());
+        m_entries.push_back(Entry{ identity, hash, static_cast<UInt32>(m_keys.size()), static_cast<UInt32>(length) });
+
+        for (size_t i = 0; i < length; i++)
+        {
+            m_keys.push_back(Fold(text[i]));
+        }
+
+        return true;
+    }
+
+    bool FoldedStringSet::Contains(const char* text, const void* identity) const
+    {
+        size_t length;
+        const UInt32 hash = FoldedHash(text, length);
+        return m_slots[Probe(text, length, hash, identity)] != EMPTY_SLOT;
+    }
+}
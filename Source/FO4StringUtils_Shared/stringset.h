@@ -0,0 +1,55 @@
+#pragma once
+
+// ========================
+// Case-Folded String Sets
+// ========================
+
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+namespace Papyrus
+{
+    // Set of strings compared without regard to case, for the array set
+    // natives.
+    //
+    // Open addressing with linear probing over a power-of-two table sized
+    // for the expected count up front, so it never rehashes. Folded keys
+    // are packed end to end in one buffer rather than stored as separate
+    // strings. Each entry also remembers an identity pointer, the interned
+    // BSFixedString entry, and a probe that meets the same pointer matches
+    // without comparing text.
+    //
+    class FoldedStringSet
+    {
+    public:
+        // expected is the most strings that will be inserted
+        //
+        explicit FoldedStringSet(size_t expected);
+
+        // Returns false if an equal string was already present
+        //
+        bool Insert(const char* text, const void* identity);
+
+        bool Contains(const char* text, const void* identity) const;
+
+        size_t Count() const { return m_entries.size(); }
+
+    private:
+        struct Entry
+        {
+            const void* identity;
+            UInt32 hash;
+            UInt32 offset;      // folded key in m_keys
+            UInt32 length;
+        };
+
+        // Slot holding text, or the empty slot where it would go
+        //
+        size_t Probe(const char* text, size_t length, UInt32 hash, const void* identity) const;
+
+        std::vector<UInt32> m_slots;        // index into m_entries, or EMPTY_SLOT
+        std::vector<Entry> m_entries;
+        std::string m_keys;
+        size_t m_mask;
+    };
+}
@@ -0,0 +1,226 @@
+// =======================
+// Localized String Tables
+// =======================
+
+#include <algorithm>                        // for std::stable_sort, std::lower_bound
+#include <cctype>                           // for std::tolower
+#include <cstring>                          // for memcpy, memchr, strlen
+
+#include "stringstable.h"                   // for StringsTable
+
+namespace Papyrus
+{
+    namespace
+    {
+        constexpr size_t HEADER_SIZE = 8;
+        constexpr size_t DIRECTORY_ENTRY_SIZE = 8;
+
+        // Tables are little-endian, as is every target the plugin builds for
+        inline UInt32 ReadUInt32(const char* p)
+        {
+            UInt32 value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        bool EndsWithNoCase(const std::string& str, const char* suffix)
+        {
+            const size_t length = strlen(suffix);
+            if (str.length() < length)
+            {
+                return false;
+            }
+
+            for (size_t i = 0; i < length; i++)
+            {
+                if (std::tolower(static_cast<unsigned char>(str[str.length() - length + i])) != suffix[i])
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    }
+
+    UInt32 StringsTable::DirectoryId(size_t index) const
+    {
+        return ReadUInt32(m_directory + index * DIRECTORY_ENTRY_SIZE);
+    }
+
+    UInt32 StringsTable::DirectoryOffset(size_t index) const
+    {
+        return ReadUInt32(m_directory + index * DIRECTORY_ENTRY_SIZE + 4);
+    }
+
+    bool StringsTable::Load(std::shared_ptr<MappedTextFile> file, StringsTableFormat format)
+    {
+        const char* bytes = file->Bytes();
+        const size_t size = file->ByteCount();
+
+        if (size < HEADER_SIZE)
+        {
+            return false;
+        }
+
+        const size_t count = ReadUInt32(bytes);
+        const size_t dataSize = ReadUInt32(bytes + 4);
+
+        // Count and size come from the file, so check them before trusting either
+        if (count > (size - HEADER_SIZE) / DIRECTORY_ENTRY_SIZE)
+        {
+            return false;
+        }
+
+        const size_t dataStart = HEADER_SIZE + count * DIRECTORY_ENTRY_SIZE;
+        if (dataSize > size - dataStart)
+        {
+            return false;
+        }
+
+        m_file = std::move(file);
+        m_format = format;
+        m_directory = bytes + HEADER_SIZE;
+        m_count = count;
+        m_data = bytes + dataStart;
+        m_dataSize = dataSize;
+
+        // One pass to confirm the order the game writes; only an unsorted
+        // table pays for a copy of its directory
+        for (size_t i = 1; i < m_count; i++)
+        {
+            if (DirectoryId(i) < DirectoryId(i - 1))
+            {
+                m_sorted.reserve(m_count);
+                for (size_t j = 0; j < m_count; j++)
+                {
+                    m_sorted.push_back(DirectoryEntry{ DirectoryId(j), DirectoryOffset(j) });
+                }
+
+                std::stable_sort(m_sorted.begin(), m_sorted.end(), [](const DirectoryEntry& a, const DirectoryEntry& b)
+                {
+                    return a.id < b.id;
+                });
+                break;
+            }
+        }
+
+        return true;
+    }
+
+    bool StringsTable::Get(UInt32 id, std::string& value) const
+    {
+        size_t offset = 0;
+
+        if (!m_sorted.empty())
+        {
+            auto it = std::lower_bound(m_sorted.begin(), m_sorted.end(), id, [](const DirectoryEntry& entry, UInt32 wanted)
+            {
+                return entry.id < wanted;
+            });
+            if (it == m_sorted.end() || it->id != id)
+            {
+                return false;
+            }
+            offset = it->offset;
+        }
+        else
+        {
+            // lower_bound over the mapped directory
+            size_t first = 0;
+            size_t length = m_count;
+            while (length > 0)
+            {
+                const size_t half = length / 2;
+                if (DirectoryId(first + half) < id)
+                {
+                    first += half + 1;
+                    length -= half + 1;
+                }
+                else
+                {
+                    length = half;
+                }
+            }
+            if (first == m_count || DirectoryId(first) != id)
+            {
+                return false;
+            }
+            offset = DirectoryOffset(first);
+        }
+
+        if (offset >= m_dataSize)
+        {
+            return false;
+        }
+
+        const char* entry = m_data + offset;
+        const size_t available = m_dataSize - offset;
+
+        if (m_format == kStringsTable_Prefixed)
+        {
+            if (available < 4)
+            {
+                return false;
+            }
+
+            // The stored length counts the trailing zero byte
+            size_t length = ReadUInt32(entry);
+            if (length > available - 4)
+            {
+                return false;
+            }
+            if (length > 0 && entry[4 + length - 1] == '\0')
+            {
+                length--;
+            }
+
+            value.assign(entry + 4, length);
+        }
+        else
+        {
+            const void* terminator = memchr(entry, '\0', available);
+            if (!terminator)
+            {
+                return false;
+            }
+
+            value.assign(entry, static_cast<const char*>(terminator) - entry);
+        }
+
+        return true;
+    }
+
+    std::shared_ptr<StringsTable> OpenDataStringsTable(const std::string& path)
+    {
+        StringsTableFormat format;
+        if (EndsWithNoCase(path, ".dlstrings") || EndsWithNoCase(path, ".ilstrings"))
+        {
+            format = kStringsTable_Prefixed;
+        }
+        else if (EndsWithNoCase(path, ".strings"))
+        {
+            format = kStringsTable_Terminated;
+        }
+        else
+        {
+            return nullptr;
+        }
+
+        // The mapping comes from the text file cache, so reopening an
+        // unchanged table does not map it again
+        std::shared_ptr<MappedTextFile> file = OpenDataTextFile(path);
+        if (!file)
+        {
+            return nullptr;
+        }
+
+        std::shared_ptr<StringsTable> table(new StringsTable());
+        if (!table->Load(std::move(file), format))
+        {
+            return nullptr;
+        }
+
+        return table;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// =======================
+// Localized String Tables
+// =======================
+
+#include <memory>                           // for std::shared_ptr
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+#include "textfile.h"                       // for MappedTextFile
+
+namespace Papyrus
+{
+    // How entries are stored in the data block, chosen by file extension
+    enum StringsTableFormat : UInt8
+    {
+        kStringsTable_Terminated = 0,       // .STRINGS: bytes up to a zero byte
+        kStringsTable_Prefixed = 1,         // .DLSTRINGS and .ILSTRINGS: UInt32 length (with the zero byte), then bytes
+    };
+
+    // A game string table, mapped rather than read.
+    //
+    // The file is a UInt32 entry count and data size, a directory of
+    // (UInt32 id, UInt32 offset) pairs, then the data block the offsets
+    // point into. The game writes the directory sorted by ID, so lookups
+    // binary-search it where it lies in the mapping; a table that is not
+    // sorted gets a sorted copy of its directory instead. Only the entries
+    // asked for are ever decoded.
+    //
+    class StringsTable
+    {
+    public:
+        // Returns false if the value is missing or its entry runs past the data block
+        //
+        bool Get(UInt32 id, std::string& value) const;
+
+        size_t Count() const { return m_count; }
+
+    private:
+        friend std::shared_ptr<StringsTable> OpenDataStringsTable(const std::string& path);
+
+        struct DirectoryEntry
+        {
+            UInt32 id;
+            UInt32 offset;
+        };
+
+        StringsTable() = default;
+
+        // Checks the header and directory; returns false if the file is not a string table
+        //
+        bool Load(std::shared_ptr<MappedTextFile> file, StringsTableFormat format);
+
+        UInt32 DirectoryId(size_t index) const;
+        UInt32 DirectoryOffset(size_t index) const;
+
+        std::shared_ptr<MappedTextFile> m_file;
+        StringsTableFormat m_format = kStringsTable_Terminated;
+
+        const char* m_directory = nullptr;
+        size_t m_count = 0;
+        const char* m_data = nullptr;
+        size_t m_dataSize = 0;
+
+        std::vector<DirectoryEntry> m_sorted;   // only filled when the file's directory is out of order
+    };
+
+    // Opens a .STRINGS, .DLSTRINGS or .ILSTRINGS file by a path relative to
+    // Data, such as "Strings\\MyMod_en.STRINGS", with the path rules of
+    // OpenDataTextFile. Only loose files are found, not ones packed in BA2
+    // archives.
+    //
+    // Returns nullptr if the path is refused, the extension is not one of
+    // the three, or the file is not a well-formed table.
+    //
+    std::shared_ptr<StringsTable> OpenDataStringsTable(const std::string& path);
+}
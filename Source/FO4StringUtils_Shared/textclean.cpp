@@ -0,0 +1,165 @@
+// ========================================
+// Whitespace and Control Character Kernels
+// ========================================
+
+#include "charclass.h"                      // for CharClassKernel
+#include "textclean.h"                      // for SkipWhitespace
+
+namespace Papyrus
+{
+    namespace
+    {
+        inline bool IsSpace(char c)
+        {
+            return IsCharOfClass<kCharClass_Whitespace>(static_cast<unsigned char>(c));
+        }
+
+#if PAPYRUS_SSE2
+        inline __m128i MatchSpace(__m128i v)
+        {
+            return CharClassKernel<kCharClass_Whitespace>::Match(v);
+        }
+
+        // Writes the lanes of v whose bit is set in keep, in order, and
+        // returns the new end. Every lane is stored, but out only moves past
+        // the kept ones, so there is no branch per byte; the stores stay
+        // within the 16 bytes after out.
+        //
+        inline char* CompactLanes(__m128i v, UInt32 keep, char* out)
+        {
+            alignas(16) char lanes[Simd::WIDTH];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), v);
+
+            for (size_t lane = 0; lane < Simd::WIDTH; lane++)
+            {
+                *out = lanes[lane];
+                out += (keep >> lane) & 1;
+            }
+            return out;
+        }
+#endif
+    }
+
+    size_t SkipWhitespace(const char* str, size_t len)
+    {
+        size_t i = 0;
+
+#if PAPYRUS_SSE2
+        for (; i + Simd::WIDTH <= len; i += Simd::WIDTH)
+        {
+            const UInt32 text = ~Simd::Mask(MatchSpace(Simd::Load(str + i))) & Simd::FULL_MASK;
+            if (text)
+            {
+                return i + Simd::LowestLane(text);
+            }
+        }
+#endif
+
+        while (i < len && IsSpace(str[i]))
+        {
+            i++;
+        }
+        return i;
+    }
+
+    size_t TrimmedEnd(const char* str, size_t len)
+    {
+        size_t end = len;
+
+#if PAPYRUS_SSE2
+        // Blocks ending at end, walking back towards the start
+        for (; end >= Simd::WIDTH; end -= Simd::WIDTH)
+        {
+            const UInt32 text = ~Simd::Mask(MatchSpace(Simd::Load(str + end - Simd::WIDTH))) & Simd::FULL_MASK;
+            if (text)
+            {
+                return end - Simd::WIDTH + Simd::HighestLane(text) + 1;
+            }
+        }
+#endif
+
+        while (end > 0 && IsSpace(str[end - 1]))
+        {
+            end--;
+        }
+        return end;
+    }
+
+    char* CollapseWhitespaceCopy(const char* in, size_t len, char* out, bool& inRun)
+    {
+        size_t i = 0;
+
+#if PAPYRUS_SSE2
+        for (; i + Simd::WIDTH <= len; i += Simd::WIDTH)
+        {
+            const __m128i v = Simd::Load(in + i);
+            const __m128i spaces = MatchSpace(v);
+            const UInt32 mask = Simd::Mask(spaces);
+
+            // Whitespace becomes ' '; a space right after another is dropped
+            const __m128i blended = _mm_or_si128(_mm_andnot_si128(spaces, v), _mm_and_si128(spaces, Simd::Splat(' ')));
+            const UInt32 dropped = mask & ((mask << 1) | (inRun ? 1u : 0u));
+            inRun = (mask >> (Simd::WIDTH - 1)) != 0;
+
+            if (dropped == 0)
+            {
+                Simd::Store(out, blended);
+                out += Simd::WIDTH;
+            }
+            else
+            {
+                out = CompactLanes(blended, ~dropped, out);
+            }
+        }
+#endif
+
+        for (; i < len; i++)
+        {
+            const bool space = IsSpace(in[i]);
+            if (!space)
+            {
+                *out++ = in[i];
+            }
+            else if (!inRun)
+            {
+                *out++ = ' ';
+            }
+            inRun = space;
+        }
+
+        return out;
+    }
+
+    char* StripControlCopy(const char* in, size_t len, char* out)
+    {
+        size_t i = 0;
+
+#if PAPYRUS_SSE2
+        for (; i + Simd::WIDTH <= len; i += Simd::WIDTH)
+        {
+            const __m128i v = Simd::Load(in + i);
+            const UInt32 mask = Simd::Mask(CharClassKernel<kCharClass_Control>::Match(v));
+
+            if (mask == 0)
+            {
+                Simd::Store(out, v);
+                out += Simd::WIDTH;
+            }
+            else
+            {
+                out = CompactLanes(v, ~mask, out);
+            }
+        }
+#endif
+
+        for (; i < len; i++)
+        {
+            if (!IsCharOfClass<kCharClass_Control>(static_cast<unsigned char>(in[i])))
+            {
+                *out++ = in[i];
+            }
+        }
+
+        return out;
+    }
+}
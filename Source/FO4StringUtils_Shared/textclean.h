@@ -0,0 +1,35 @@
+#pragma once
+
+// ========================================
+// Whitespace and Control Character Kernels
+// ========================================
+
+// Whitespace here is the kCharClass_Whitespace class: space, \t, \n, \v, \f
+// and \r, the same set IsWhitespace and SplitWhitespace use. Each kernel
+// classifies 16 bytes at a time and falls back to the class table for the
+// bytes left over.
+
+#include <cstddef>                          // for size_t
+
+namespace Papyrus
+{
+    // Index of the first byte that is not whitespace, or len if there is none
+    //
+    size_t SkipWhitespace(const char* str, size_t len);
+
+    // One past the last byte that is not whitespace, or 0 if there is none
+    //
+    size_t TrimmedEnd(const char* str, size_t len);
+
+    // Copies in to out with every whitespace run replaced by one space.
+    // inRun says whether in continues a run from an earlier call and is
+    // updated for the next. out needs room for len bytes; returns the end
+    // of what was written.
+    //
+    char* CollapseWhitespaceCopy(const char* in, size_t len, char* out, bool& inRun);
+
+    // Copies in to out without control characters (0-31 and 127). out needs
+    // room for len bytes; returns the end of what was written.
+    //
+    char* StripControlCopy(const char* in, size_t len, char* out);
+}
@@ -0,0 +1,385 @@
+// ======================
+// Read-Only Data Files
+// ======================
+
+#include <cstring>                          // for memchr, memcmp
+
+#ifndef _WIN32
+#include <fcntl.h>                          // for open
+#include <sys/mman.h>                       // for mmap
+#include <sys/stat.h>                       // for stat, fstat
+#include <unistd.h>                         // for read, close
+#endif
+
+#include "textfile.h"                       // for MappedTextFile
+
+namespace Papyrus
+{
+    namespace
+    {
+#ifdef _WIN32
+        constexpr char PATH_SEPARATOR = '\\';
+#else
+        constexpr char PATH_SEPARATOR = '/';
+#endif
+
+        struct CachedFile
+        {
+            std::string fullPath;
+            std::weak_ptr<MappedTextFile> file;
+            std::shared_ptr<MappedTextFile> pinned;     // copied files only; a mapping must not outlive its readers
+            UInt64 lastUse;
+        };
+
+        std::mutex g_cacheLock;
+        std::vector<CachedFile> g_cache;
+        UInt64 g_cacheClock = 0;
+
+        // "Folder\\file.txt" -> ".\\Data\\Folder\\file.txt". Refuses anything
+        // that could name a file outside Data: drive letters and other
+        // colons, a leading separator, and ".." components.
+        //
+        bool ResolveDataPath(const std::string& path, std::string& fullPath)
+        {
+            if (path.empty() || path.find(':') != std::string::npos || path[0] == '\\' || path[0] == '/')
+            {
+                return false;
+            }
+
+            fullPath = std::string(".") + PATH_SEPARATOR + "Data" + PATH_SEPARATOR;
+            size_t componentStart = fullPath.length();
+
+            for (size_t i = 0; i <= path.length(); i++)
+            {
+                const bool atEnd = i == path.length();
+
+                if (atEnd || path[i] == '\\' || path[i] == '/')
+                {
+                    if (fullPath.compare(componentStart, std::string::npos, "..") == 0)
+                    {
+                        return false;
+                    }
+                    if (!atEnd)
+                    {
+                        fullPath.push_back(PATH_SEPARATOR);
+                        componentStart = fullPath.length();
+                    }
+                }
+                else
+                {
+                    fullPath.push_back(path[i]);
+                }
+            }
+
+            return true;
+        }
+
+        // Size and last write time; false if there is no regular file there
+        //
+        bool StatFile(const std::string& fullPath, UInt64& size, UInt64& modified)
+        {
+#ifdef _WIN32
+            WIN32_FILE_ATTRIBUTE_DATA data;
+            if (!GetFileAttributesExA(fullPath.c_str(), GetFileExInfoStandard, &data) || (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            {
+                return false;
+            }
+
+            size = (static_cast<UInt64>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+            modified = (static_cast<UInt64>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+#else
+            struct stat info;
+            if (stat(fullPath.c_str(), &info) != 0 || !S_ISREG(info.st_mode))
+            {
+                return false;
+            }
+
+            size = static_cast<UInt64>(info.st_size);
+            modified = static_cast<UInt64>(info.st_mtim.tv_sec) * 1000000000u + static_cast<UInt64>(info.st_mtim.tv_nsec);
+#endif
+            return true;
+        }
+    }
+
+    MappedTextFile::~MappedTextFile()
+    {
+        if (!m_view)
+        {
+            return;
+        }
+
+#ifdef _WIN32
+        UnmapViewOfFile(m_view);
+#else
+        munmap(m_view, m_byteCount);
+#endif
+    }
+
+    bool MappedTextFile::Load(const std::string& fullPath)
+    {
+        // Nothing to read; an empty view is refused by both platforms anyway
+        if (m_size == 0)
+        {
+            return true;
+        }
+
+        const size_t size = static_cast<size_t>(m_size);
+        const bool copy = m_size <= MAX_COPIED_TEXT_FILE_SIZE;
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        // The file may have changed since it was stat'ed; the view must not
+        // reach past its end
+        LARGE_INTEGER opened;
+        if (!GetFileSizeEx(file, &opened) || static_cast<UInt64>(opened.QuadPart) != m_size)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        if (copy)
+        {
+            m_copy.resize(size);
+            DWORD read = 0;
+            const BOOL ok = ReadFile(file, &m_copy[0], static_cast<DWORD>(size), &read, NULL);
+            CloseHandle(file);
+            if (!ok || read != size)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            CloseHandle(file);
+            if (!mapping)
+            {
+                return false;
+            }
+
+            // The view keeps the mapping object alive after its handle is closed
+            m_view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+            CloseHandle(mapping);
+            if (!m_view)
+            {
+                return false;
+            }
+        }
+#else
+        const int file = open(fullPath.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            return false;
+        }
+
+        struct stat opened;
+        if (fstat(file, &opened) != 0 || static_cast<UInt64>(opened.st_size) != m_size)
+        {
+            close(file);
+            return false;
+        }
+
+        if (copy)
+        {
+            m_copy.resize(size);
+            size_t done = 0;
+            while (done < size)
+            {
+                const ssize_t read = ::read(file, &m_copy[done], size - done);
+                if (read <= 0)
+                {
+                    break;
+                }
+                done += static_cast<size_t>(read);
+            }
+            close(file);
+            if (done != size)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+            close(file);
+            if (view == MAP_FAILED)
+            {
+                return false;
+            }
+
+            m_view = view;
+        }
+#endif
+        m_bytes = copy ? m_copy.data() : static_cast<const char*>(m_view);
+        m_byteCount = size;
+        m_text = m_bytes;
+        m_length = m_byteCount;
+
+        // Skip a UTF-8 byte order mark
+        if (m_length >= 3 && memcmp(m_text, "\xEF\xBB\xBF", 3) == 0)
+        {
+            m_text += 3;
+            m_length -= 3;
+        }
+
+        return true;
+    }
+
+    void MappedTextFile::BuildLineIndex()
+    {
+        if (m_length > 0)
+        {
+            m_lineStarts.push_back(0);
+        }
+
+        size_t position = 0;
+        while (const void* newline = memchr(m_text + position, '\n', m_length - position))
+        {
+            position = static_cast<const char*>(newline) - m_text + 1;
+
+            // A newline at the very end closes the last line without opening another
+            if (position < m_length)
+            {
+                m_lineStarts.push_back(static_cast<UInt32>(position));
+            }
+        }
+
+        // End of the last line
+        m_lineStarts.push_back(static_cast<UInt32>(m_length));
+    }
+
+    size_t MappedTextFile::LineCount()
+    {
+        std::call_once(m_indexOnce, &MappedTextFile::BuildLineIndex, this);
+        return m_lineStarts.size() - 1;
+    }
+
+    std::string MappedTextFile::Line(size_t index)
+    {
+        if (index >= LineCount())
+        {
+            return std::string();
+        }
+
+        const size_t start = m_lineStarts[index];
+        size_t end = m_lineStarts[index + 1];
+
+        // Drop the terminator, "\n" or "\r\n"
+        if (end > start && m_text[end - 1] == '\n')
+        {
+            end--;
+        }
+        if (end > start && m_text[end - 1] == '\r')
+        {
+            end--;
+        }
+
+        return std::string(m_text + start, end - start);
+    }
+
+    std::vector<std::string> MappedTextFile::Lines()
+    {
+        const size_t count = LineCount();
+        std::vector<std::string> lines;
+        lines.reserve(count);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            lines.push_back(Line(i));
+        }
+
+        return lines;
+    }
+
+    std::shared_ptr<MappedTextFile> OpenDataTextFile(const std::string& path)
+    {
+        std::string fullPath;
+        UInt64 size = 0;
+        UInt64 modified = 0;
+
+        if (!ResolveDataPath(path, fullPath) || !StatFile(fullPath, size, modified) || size > MAX_TEXT_FILE_SIZE)
+        {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(g_cacheLock);
+
+        // Reuse the loaded file while it is unchanged on disk
+        CachedFile* slot = nullptr;
+        for (CachedFile& entry : g_cache)
+        {
+            if (entry.fullPath == fullPath)
+            {
+                slot = &entry;
+                break;
+            }
+        }
+
+        if (slot)
+        {
+            std::shared_ptr<MappedTextFile> cached = slot->file.lock();
+            if (cached && cached->m_size == size && cached->m_modified == modified)
+            {
+                slot->lastUse = ++g_cacheClock;
+                return cached;
+            }
+        }
+
+        std::shared_ptr<MappedTextFile> file(new MappedTextFile());
+        file->m_size = size;
+        file->m_modified = modified;
+
+        if (!file->Load(fullPath))
+        {
+            return nullptr;
+        }
+
+        // Stale entry for this path, an expired one, a free slot, or the least recently used
+        if (!slot)
+        {
+            for (CachedFile& entry : g_cache)
+            {
+                if (entry.file.expired())
+                {
+                    slot = &entry;
+                    slot->fullPath = fullPath;
+                    break;
+                }
+            }
+        }
+
+        if (!slot)
+        {
+            if (g_cache.size() < TEXT_FILE_CACHE_ENTRIES)
+            {
+                g_cache.push_back(CachedFile());
+                slot = &g_cache.back();
+                slot->fullPath = fullPath;
+            }
+            else
+            {
+                slot = &g_cache[0];
+                for (CachedFile& entry : g_cache)
+                {
+                    if (entry.lastUse < slot->lastUse)
+                    {
+                        slot = &entry;
+                    }
+                }
+                slot->fullPath = fullPath;
+            }
+        }
+
+        // Readers still holding the old version keep it until they finish
+        slot->file = file;
+        slot->pinned = file->m_view ? nullptr : file;
+        slot->lastUse = ++g_cacheClock;
+
+        return file;
+    }
+}
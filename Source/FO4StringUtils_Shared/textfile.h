@@ -0,0 +1,96 @@
+#pragma once
+
+// ======================
+// Read-Only Data Files
+// ======================
+
+#include <memory>                           // for std::shared_ptr
+#include <mutex>                            // for std::once_flag
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+namespace Papyrus
+{
+    // Files remembered between calls; the least recently used is dropped
+    constexpr size_t TEXT_FILE_CACHE_ENTRIES = 16;
+
+    // Files up to this size are read into memory and closed straight away,
+    // so a mod or editor can still rewrite them while the game runs
+    constexpr UInt64 MAX_COPIED_TEXT_FILE_SIZE = static_cast<UInt64>(4u) * 1024u * 1024u;
+
+    // Larger files are refused so line offsets fit in 32 bits
+    constexpr UInt64 MAX_TEXT_FILE_SIZE = static_cast<UInt64>(256u) * 1024u * 1024u;
+
+    // A text file under Data, loaded for reading.
+    //
+    // Files up to MAX_COPIED_TEXT_FILE_SIZE are copied into memory. Larger
+    // ones are mapped, and the mapping lasts only while a reader holds the
+    // object: the cache keeps just a weak reference to it. While mapped, the
+    // file cannot be truncated on Windows, and truncating it elsewhere makes
+    // reads past the new end fault.
+    //
+    // The line index is built the first time a line is asked for, with one
+    // memchr pass over the text. Lines end at "\n"; a "\r" before it is
+    // dropped, and a newline at the very end does not start another line.
+    // A UTF-8 byte order mark at the start is skipped.
+    //
+    class MappedTextFile
+    {
+    public:
+        MappedTextFile(const MappedTextFile&) = delete;
+        MappedTextFile& operator=(const MappedTextFile&) = delete;
+        ~MappedTextFile();
+
+        const char* Text() const { return m_text; }
+        size_t Length() const { return m_length; }
+
+        // The whole file, byte order mark included, for binary formats
+        const char* Bytes() const { return m_bytes; }
+        size_t ByteCount() const { return m_byteCount; }
+
+        size_t LineCount();
+
+        // Empty if index is past the last line
+        //
+        std::string Line(size_t index);
+
+        // Usage: std::vector<std::string> lines = file->Lines();
+        //
+        std::vector<std::string> Lines();
+
+    private:
+        friend std::shared_ptr<MappedTextFile> OpenDataTextFile(const std::string& path);
+
+        MappedTextFile() = default;
+
+        // Returns false if the file could not be read, or its size no
+        // longer matches m_size from the earlier stat
+        //
+        bool Load(const std::string& fullPath);
+
+        void BuildLineIndex();
+
+        std::string m_copy;                 // contents of a small file
+        void* m_view = nullptr;             // mapping of a large one
+        const char* m_bytes = "";
+        size_t m_byteCount = 0;
+
+        const char* m_text = "";
+        size_t m_length = 0;
+
+        UInt64 m_modified = 0;
+        UInt64 m_size = 0;
+
+        std::once_flag m_indexOnce;
+        std::vector<UInt32> m_lineStarts;   // offset of each line in m_text, plus m_length at the end
+    };
+
+    // Opens a file by a path relative to the Data folder, such as
+    // "F4SE\\Plugins\\MyMod\\names.txt". Absolute paths and ".." components
+    // are refused. A cached file is reused until its size or modification
+    // time changes.
+    //
+    // Returns nullptr if the path is refused or the file cannot be read.
+    //
+    std::shared_ptr<MappedTextFile> OpenDataTextFile(const std::string& path);
+}
@@ -0,0 +1,201 @@
+// ===================
+// Inverted Word Index
+// ===================
+
+#include <algorithm>                        // for std::sort, std::set_union
+#include <iterator>                         // for std::back_inserter
+
+#include "textindex.h"                      // for TextIndex
+
+namespace Papyrus
+{
+    namespace
+    {
+        // Append a value using 7 bits per byte, high bit set on all but the last byte
+        //
+        void AppendVarint(std::vector<UInt8>& bytes, UInt32 value)
+        {
+            while (value >= 0x80)
+            {
+                bytes.push_back(static_cast<UInt8>(value | 0x80));
+                value >>= 7;
+            }
+            bytes.push_back(static_cast<UInt8>(value));
+        }
+
+        // Streams the entry numbers back out of a compressed posting list
+        //
+        class PostingReader
+        {
+        public:
+            explicit PostingReader(const std::vector<UInt8>& bytes)
+                : m_pos(bytes.data()), m_end(bytes.data() + bytes.size())
+            {
+            }
+
+            // Returns false once the list is exhausted
+            //
+            bool Next(UInt32& entry)
+            {
+                if (m_pos == m_end)
+                {
+                    return false;
+                }
+
+                UInt32 delta = 0;
+                int shift = 0;
+                while (m_pos != m_end)
+                {
+                    const UInt8 b = *m_pos++;
+                    delta |= static_cast<UInt32>(b & 0x7F) << shift;
+                    if ((b & 0x80) == 0)
+                    {
+                        break;
+                    }
+                    shift += 7;
+                }
+
+                // First value is stored absolute, the rest as gaps
+                m_current = m_started ? m_current + delta : delta;
+                m_started = true;
+                entry = m_current;
+                return true;
+            }
+
+        private:
+            const UInt8* m_pos;
+            const UInt8* m_end;
+            UInt32 m_current = 0;
+            bool m_started = false;
+        };
+    }
+
+    TextIndex::TextIndex(const std::vector<std::string>& entries)
+        : m_entryCount(static_cast<UInt32>(entries.size()))
+    {
+        for (UInt32 entry = 0; entry < m_entryCount; ++entry)
+        {
+            ForEachWord(entries[entry], [this, entry](const std::string& word)
+            {
+                PostingList& list = m_postings[word];
+
+                // A word repeated within one entry is only posted once
+                if (list.count > 0 && list.last == entry)
+                {
+                    return;
+                }
+
+                AppendVarint(list.bytes, list.count == 0 ? entry : entry - list.last);
+                list.last = entry;
+                list.count++;
+            });
+        }
+
+        // Index is read-only from here on so drop the growth slack
+        for (auto& posting : m_postings)
+        {
+            posting.second.bytes.shrink_to_fit();
+        }
+    }
+
+    std::vector<UInt32> TextIndex::QueryAll(const std::vector<std::string>& words) const
+    {
+        std::vector<const PostingList*> lists;
+        lists.reserve(words.size());
+
+        for (const std::string& word : words)
+        {
+            auto it = m_postings.find(word);
+
+            // A word that is nowhere in the index means nothing can match
+            if (it == m_postings.end())
+            {
+                return std::vector<UInt32>();
+            }
+            lists.push_back(&it->second);
+        }
+
+        // Intersect rarest first so the candidate set is small from the start
+        std::sort(lists.begin(), lists.end(), [](const PostingList* a, const PostingList* b)
+        {
+            return a->count < b->count;
+        });
+
+        std::vector<UInt32> result;
+        result.reserve(lists.front()->count);
+
+        PostingReader first(lists.front()->bytes);
+        UInt32 entry = 0;
+        while (first.Next(entry))
+        {
+            result.push_back(entry);
+        }
+
+        // Merge each remaining list against the survivors without decoding it to memory
+        for (size_t i = 1; i < lists.size() && !result.empty(); ++i)
+        {
+            PostingReader reader(lists[i]->bytes);
+            size_t kept = 0;
+            size_t pos = 0;
+            bool more = reader.Next(entry);
+
+            while (more && pos < result.size())
+            {
+                if (entry < result[pos])
+                {
+                    more = reader.Next(entry);
+                }
+                else if (entry > result[pos])
+                {
+                    pos++;
+                }
+                else
+                {
+                    result[kept++] = entry;
+                    pos++;
+                    more = reader.Next(entry);
+                }
+            }
+
+            result.resize(kept);
+        }
+
+        return result;
+    }
+
+    std::vector<UInt32> TextIndex::Query(const std::string& query) const
+    {
+        std::vector<UInt32> result;
+
+        size_t start = 0;
+        while (start <= query.length())
+        {
+            // Each '|' separated group is one AND clause
+            size_t end = query.find('|', start);
+            if (end == std::string::npos)
+            {
+                end = query.length();
+            }
+
+            std::vector<std::string> words;
+            ForEachWord(query.substr(start, end - start), [&words](const std::string& word)
+            {
+                words.push_back(word);
+            });
+
+            // Empty clauses (e.g. "a||b") are ignored rather than matching everything
+            if (!words.empty())
+            {
+                std::vector<UInt32> clause = QueryAll(words);
+                std::vector<UInt32> merged;
+                merged.reserve(result.size() + clause.size());
+                std::set_union(result.begin(), result.end(), clause.begin(), clause.end(), std::back_inserter(merged));
+                result.swap(merged);
+            }
+
+            start = end + 1;
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+// =========================
+// Inverted Word Index Types
+// =========================
+
+#include <string>                           // for std::string
+#include <unordered_map>                    // for std::unordered_map
+#include <vector>                           // for std::vector
+
+#include "functions.h"                      // for IsWordSeparator
+
+namespace Papyrus
+{
+    // Inverted index from lowercase words to the entries containing them.
+    //
+    // Words are maximal runs of characters that are not IsWordSeparator, so the
+    // index agrees with ToTitleCase about where words start and end. Each
+    // posting list holds ascending entry numbers stored as varint deltas.
+    //
+    class TextIndex
+    {
+    public:
+        explicit TextIndex(const std::vector<std::string>& entries);
+
+        // Usage: "plasma rifle|laser" -> entries with (plasma AND rifle) OR laser
+        //
+        std::vector<UInt32> Query(const std::string& query) const;
+
+        UInt32 EntryCount() const { return m_entryCount; }
+
+    private:
+        struct PostingList
+        {
+            std::vector<UInt8> bytes;   // varint encoded deltas between entry numbers
+            UInt32 count = 0;           // number of entries in the list
+            UInt32 last = 0;            // last entry appended, used while building
+        };
+
+        std::vector<UInt32> QueryAll(const std::vector<std::string>& words) const;
+
+        std::unordered_map<std::string, PostingList> m_postings;
+        UInt32 m_entryCount;
+    };
+
+    // Calls onWord(const std::string&) for every lowercase word in the text
+    //
+    template <typename F>
+    void ForEachWord(const std::string& text, F onWord)
+    {
+        std::string word;
+
+        for (unsigned char c : text)
+        {
+            if (IsWordSeparator(c))
+            {
+                if (!word.empty())
+                {
+                    onWord(word);
+                    word.clear();
+                }
+            }
+            else
+            {
+                word.push_back(static_cast<char>(std::tolower(c)));
+            }
+        }
+
+        // Trailing word with no separator after it
+        if (!word.empty())
+        {
+            onWord(word);
+        }
+    }
+}
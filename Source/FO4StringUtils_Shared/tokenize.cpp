@@ -0,0 +1,151 @@
+// ===============
+// Token Splitting
+// ===============
+
+#include <algorithm>                        // for std::search
+
+#include "charclass.h"                      // for CharClassKernel
+#include "tokenize.h"                       // for DelimiterSet
+
+namespace Papyrus
+{
+    namespace
+    {
+        // Whitespace in the same shape as DelimiterSet, for ScanTokens
+        struct WhitespaceMatcher
+        {
+            bool Contains(unsigned char c) const { return IsCharOfClass<kCharClass_Whitespace>(c); }
+
+            bool HasVectorForm() const { return true; }
+
+#if PAPYRUS_SSE2
+            __m128i Match(__m128i v) const { return CharClassKernel<kCharClass_Whitespace>::Match(v); }
+#endif
+        };
+
+        // Records the tokens between delimiter bytes. Blocks of 16 bytes are
+        // classified at once and only their delimiter lanes are visited, so
+        // long tokens cost one compare per block rather than per byte.
+        //
+        template <typename Matcher>
+        void ScanTokens(const char* str, size_t len, const Matcher& matcher, bool dropEmpty, std::vector<TokenSpan>& spans)
+        {
+            size_t tokenStart = 0;
+            auto endToken = [&](size_t end)
+            {
+                if (!dropEmpty || end > tokenStart)
+                {
+                    spans.push_back(TokenSpan{ static_cast<UInt32>(tokenStart), static_cast<UInt32>(end - tokenStart) });
+                }
+                tokenStart = end + 1;
+            };
+
+            size_t i = 0;
+
+#if PAPYRUS_SSE2
+            if (matcher.HasVectorForm())
+            {
+                for (; i + Simd::WIDTH <= len; i += Simd::WIDTH)
+                {
+                    UInt32 mask = Simd::Mask(matcher.Match(Simd::Load(str + i)));
+                    while (mask)
+                    {
+                        endToken(i + Simd::LowestLane(mask));
+                        mask &= mask - 1;
+                    }
+                }
+            }
+#endif
+
+            for (; i < len; i++)
+            {
+                if (matcher.Contains(static_cast<unsigned char>(str[i])))
+                {
+                    endToken(i);
+                }
+            }
+
+            // The text after the last delimiter
+            if (!dropEmpty || len > tokenStart)
+            {
+                spans.push_back(TokenSpan{ static_cast<UInt32>(tokenStart), static_cast<UInt32>(len - tokenStart) });
+            }
+        }
+    }
+
+    DelimiterSet::DelimiterSet(const std::string& chars)
+    {
+        for (char ch : chars)
+        {
+            const unsigned char c = static_cast<unsigned char>(ch);
+            if (Contains(c))
+            {
+                continue;
+            }
+
+            m_bits[c >> 5] |= 1u << (c & 31);
+            if (m_count < MAX_VECTOR_BYTES)
+            {
+                m_bytes[m_count] = ch;
+            }
+            m_count++;
+        }
+    }
+
+#if PAPYRUS_SSE2
+    __m128i DelimiterSet::Match(__m128i v) const
+    {
+        __m128i match = _mm_setzero_si128();
+        for (size_t i = 0; i < m_count; i++)
+        {
+            match = _mm_or_si128(match, Simd::Equal(v, m_bytes[i]));
+        }
+        return match;
+    }
+#endif
+
+    void SplitAnySpans(const char* str, size_t len, const DelimiterSet& delimiters, bool dropEmpty, std::vector<TokenSpan>& spans)
+    {
+        ScanTokens(str, len, delimiters, dropEmpty, spans);
+    }
+
+    void SplitWhitespaceSpans(const char* str, size_t len, std::vector<TokenSpan>& spans)
+    {
+        ScanTokens(str, len, WhitespaceMatcher(), true, spans);
+    }
+
+    void SplitLiteralSpans(const char* str, size_t len, const std::string& delimiter, std::vector<TokenSpan>& spans)
+    {
+        const size_t delimiterLen = delimiter.length();
+
+        if (delimiterLen == 0)
+        {
+            for (size_t i = 0; i < len; i++)
+            {
+                spans.push_back(TokenSpan{ static_cast<UInt32>(i), 1 });
+            }
+            return;
+        }
+
+        // A one-byte delimiter is a one-member set, and gets the vector scan
+        if (delimiterLen == 1)
+        {
+            ScanTokens(str, len, DelimiterSet(delimiter), false, spans);
+            return;
+        }
+
+        size_t tokenStart = 0;
+        for (;;)
+        {
+            const char* found = std::search(str + tokenStart, str + len, delimiter.begin(), delimiter.end());
+            const size_t end = static_cast<size_t>(found - str);
+
+            spans.push_back(TokenSpan{ static_cast<UInt32>(tokenStart), static_cast<UInt32>(end - tokenStart) });
+            if (end == len)
+            {
+                break;
+            }
+            tokenStart = end + delimiterLen;
+        }
+    }
+}
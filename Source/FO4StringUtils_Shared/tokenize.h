@@ -0,0 +1,69 @@
+#pragma once
+
+// ===============
+// Token Splitting
+// ===============
+
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+#include "simd.h"                           // for Simd
+
+namespace Papyrus
+{
+    // Where one token sits in its source string
+    struct TokenSpan
+    {
+        UInt32 start;
+        UInt32 length;
+    };
+
+    // A set of single-byte delimiters, such as ",;|".
+    //
+    // Membership is a 256-bit bitmap. A set of up to MAX_VECTOR_BYTES
+    // distinct bytes is also kept as a list, so a block of 16 characters can
+    // be classified with one compare per delimiter; larger sets test the
+    // bitmap a byte at a time.
+    //
+    class DelimiterSet
+    {
+    public:
+        static constexpr size_t MAX_VECTOR_BYTES = 8;
+
+        explicit DelimiterSet(const std::string& chars);
+
+        bool Contains(unsigned char c) const { return (m_bits[c >> 5] >> (c & 31)) & 1; }
+
+        bool IsEmpty() const { return m_count == 0; }
+
+        bool HasVectorForm() const { return m_count <= MAX_VECTOR_BYTES; }
+
+#if PAPYRUS_SSE2
+        // Lanes holding a delimiter; only for sets with HasVectorForm()
+        //
+        __m128i Match(__m128i v) const;
+#endif
+
+    private:
+        UInt32 m_bits[8] = { };
+        char m_bytes[MAX_VECTOR_BYTES] = { };
+        size_t m_count = 0;
+    };
+
+    // Appends the tokens of str between delimiter bytes, like Split with
+    // every byte of the set as a delimiter. Unless dropEmpty, adjacent
+    // delimiters give empty tokens and there is always at least one token.
+    //
+    void SplitAnySpans(const char* str, size_t len, const DelimiterSet& delimiters, bool dropEmpty, std::vector<TokenSpan>& spans);
+
+    // Appends the runs of non-whitespace in str. Whitespace is the
+    // kCharClass_Whitespace class, the same set IsWhitespace tests.
+    //
+    void SplitWhitespaceSpans(const char* str, size_t len, std::vector<TokenSpan>& spans);
+
+    // Appends the tokens of str between occurrences of delimiter, cut the
+    // way Split cuts them: matching is exact, and an empty delimiter gives
+    // one token per character.
+    //
+    void SplitLiteralSpans(const char* str, size_t len, const std::string& delimiter, std::vector<TokenSpan>& spans);
+}
@@ -0,0 +1,185 @@
+// =====================
+// Native Call Timelines
+// =====================
+
+#include <algorithm>                        // for std::sort
+#include <atomic>                           // for std::atomic
+#include <cstdio>                           // for fopen, fprintf
+#include <vector>                           // for std::vector
+
+#include "functions.h"                      // for PAPYRUS_CLASS_NAME
+#include "stats.h"                          // for Stats::FunctionName
+#include "trace.h"                          // for Trace
+
+namespace Papyrus
+{
+    namespace Trace
+    {
+        namespace
+        {
+            // One ring buffer slot. The sequence works like a seqlock: it is
+            // zeroed before the fields change and set to index + 1 after, so a
+            // reader can tell a finished event from one being overwritten.
+            // Fields are relaxed atomics only to keep that race well defined.
+            struct Event
+            {
+                std::atomic<UInt64> sequence;
+                std::atomic<UInt64> begin;
+                std::atomic<UInt64> end;
+                std::atomic<UInt32> threadId;
+                std::atomic<UInt32> functionId;
+                std::atomic<UInt32> bytesIn;
+                std::atomic<UInt32> bytesOut;
+            };
+
+            // Plain copy taken by Flush
+            struct Snapshot
+            {
+                UInt64 begin;
+                UInt64 end;
+                UInt32 threadId;
+                UInt32 functionId;
+                UInt32 bytesIn;
+                UInt32 bytesOut;
+            };
+
+            // Allocated once by Start and never freed or resized
+            std::atomic<Event*> g_events(nullptr);
+            UInt32 g_capacity = 0;
+
+            // Total events ever recorded; slot is g_head % g_capacity
+            std::atomic<UInt64> g_head(0);
+
+            inline UInt32 Clamp32(UInt64 value)
+            {
+                return value > 0xFFFFFFFFull ? 0xFFFFFFFFu : static_cast<UInt32>(value);
+            }
+        }
+
+        void Start(UInt32 capacity)
+        {
+            if (g_events.load())
+            {
+                return;
+            }
+
+            if (capacity == 0)
+            {
+                capacity = DEFAULT_CAPACITY;
+            }
+            if (capacity > MAX_CAPACITY)
+            {
+                capacity = MAX_CAPACITY;
+            }
+
+            g_capacity = capacity;
+            g_events.store(new Event[capacity]());
+
+            _MESSAGE("%s trace enabled, %u events", PAPYRUS_CLASS_NAME, capacity);
+        }
+
+        void Record(UInt32 id, UInt64 begin, UInt64 end, UInt64 bytesIn, UInt64 bytesOut)
+        {
+            Event* events = g_events.load(std::memory_order_acquire);
+            if (!events)
+            {
+                return;
+            }
+
+            // Claiming a slot is the only shared write; no thread ever waits
+            const UInt64 index = g_head.fetch_add(1, std::memory_order_relaxed);
+            Event& e = events[index % g_capacity];
+
+            e.sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            e.begin.store(begin, std::memory_order_relaxed);
+            e.end.store(end, std::memory_order_relaxed);
+            e.threadId.store(static_cast<UInt32>(GetCurrentThreadId()), std::memory_order_relaxed);
+            e.functionId.store(id, std::memory_order_relaxed);
+            e.bytesIn.store(Clamp32(bytesIn), std::memory_order_relaxed);
+            e.bytesOut.store(Clamp32(bytesOut), std::memory_order_relaxed);
+
+            e.sequence.store(index + 1, std::memory_order_release);
+        }
+
+        bool Flush(const std::string& path)
+        {
+            Event* events = g_events.load(std::memory_order_acquire);
+            if (!events)
+            {
+                return false;
+            }
+
+            // Copy out the newest g_capacity events, skipping torn slots
+            const UInt64 head = g_head.load(std::memory_order_acquire);
+            const UInt64 first = head > g_capacity ? head - g_capacity : 0;
+
+            std::vector<Snapshot> snapshots;
+            snapshots.reserve(static_cast<size_t>(head - first));
+
+            for (UInt64 index = first; index < head; ++index)
+            {
+                const Event& e = events[index % g_capacity];
+
+                if (e.sequence.load(std::memory_order_acquire) != index + 1)
+                {
+                    continue;
+                }
+
+                Snapshot s;
+                s.begin = e.begin.load(std::memory_order_relaxed);
+                s.end = e.end.load(std::memory_order_relaxed);
+                s.threadId = e.threadId.load(std::memory_order_relaxed);
+                s.functionId = e.functionId.load(std::memory_order_relaxed);
+                s.bytesIn = e.bytesIn.load(std::memory_order_relaxed);
+                s.bytesOut = e.bytesOut.load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (e.sequence.load(std::memory_order_relaxed) != index + 1)
+                {
+                    continue;
+                }
+
+                snapshots.push_back(s);
+            }
+
+            std::sort(snapshots.begin(), snapshots.end(), [](const Snapshot& a, const Snapshot& b)
+            {
+                return a.begin < b.begin;
+            });
+
+            FILE* file = fopen(path.c_str(), "w");
+            if (!file)
+            {
+                return false;
+            }
+
+            // Timestamps are microseconds from the oldest event kept
+            const UInt64 origin = snapshots.empty() ? 0 : snapshots.front().begin;
+            const double ticksPerMicrosecond = Stats::TicksPerMicrosecond();
+
+            fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+            fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"%s\"}}", PAPYRUS_CLASS_NAME);
+
+            for (const Snapshot& s : snapshots)
+            {
+                fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"papyrus\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"in\":%u,\"out\":%u}}",
+                    Stats::FunctionName(s.functionId),
+                    s.threadId,
+                    (s.begin - origin) / ticksPerMicrosecond,
+                    (s.end - s.begin) / ticksPerMicrosecond,
+                    s.bytesIn,
+                    s.bytesOut);
+            }
+
+            fprintf(file, "\n]}\n");
+
+            const bool ok = ferror(file) == 0;
+            fclose(file);
+
+            _MESSAGE("%s trace wrote %u events to %s", PAPYRUS_CLASS_NAME, static_cast<UInt32>(snapshots.size()), path.c_str());
+            return ok;
+        }
+    }
+}
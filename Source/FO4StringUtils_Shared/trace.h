@@ -0,0 +1,32 @@
+#pragma once
+
+// =====================
+// Native Call Timelines
+// =====================
+
+#include <string>                           // for std::string
+
+namespace Papyrus
+{
+    namespace Trace
+    {
+        // Ring buffer size used when the INI does not give one
+        constexpr UInt32 DEFAULT_CAPACITY = 65536;
+
+        // Bounds memory to a few MB however long the game runs
+        constexpr UInt32 MAX_CAPACITY = 1u << 20;
+
+        // Allocate the ring buffer; later calls are ignored
+        //
+        void Start(UInt32 capacity);
+
+        // Store one call, overwriting the oldest once the buffer is full
+        //
+        void Record(UInt32 id, UInt64 begin, UInt64 end, UInt64 bytesIn, UInt64 bytesOut);
+
+        // Write the buffered calls as Chrome trace-event JSON.
+        // Returns false if tracing is off or the file cannot be written.
+        //
+        bool Flush(const std::string& path);
+    }
+}
@@ -0,0 +1,306 @@
+// ================
+// Fused Transforms
+// ================
+
+#include <algorithm>                        // for std::min
+#include <cctype>                           // for std::toupper
+#include <memory>                           // for std::unique_ptr
+
+#include "functions.h"                      // for IsWordSeparator, ToLowerCopy
+#include "textclean.h"                      // for SkipWhitespace
+#include "transform.h"                      // for TextTransform
+
+namespace Papyrus
+{
+    namespace
+    {
+        struct CachedTransform
+        {
+            BSFixedString spec;             // held so its address cannot be reused for other text
+            std::unique_ptr<TextTransform> transform;
+            UInt64 lastUse = 0;
+        };
+
+        struct TransformCache
+        {
+            CachedTransform entries[TRANSFORM_CACHE_ENTRIES];
+            UInt64 clock = 0;
+        };
+
+        // Leaked on purpose, as the source cache is
+        thread_local TransformCache* t_transformCache = nullptr;
+
+        // std::toupper and std::tolower for every byte, as ToTitleCase maps them
+        struct CaseTables
+        {
+            char upper[256];
+            char lower[256];
+
+            CaseTables()
+            {
+                for (int i = 0; i < 256; i++)
+                {
+                    upper[i] = static_cast<char>(std::toupper(i));
+                    lower[i] = static_cast<char>(std::tolower(i));
+                }
+            }
+        };
+
+        const CaseTables g_case;
+
+        // Per-op state carried from one block to the next
+        struct OpState
+        {
+            bool flag = false;              // TrimStart: text seen; Collapse: in a run; Title: in a word
+            std::string held;               // TrimEnd: whitespace not yet known to be trailing
+        };
+
+        // Appends up to maxLength bytes to out through write, which returns
+        // the end of what it wrote
+        //
+        template <typename Writer>
+        inline void AppendWith(std::string& out, size_t maxLength, Writer write)
+        {
+            const size_t base = out.size();
+            out.resize(base + maxLength);
+            char* const begin = &out[0];
+            out.resize(write(begin + base) - begin);
+        }
+
+        void TrimStartBlock(OpState& state, const char* in, size_t length, std::string& out)
+        {
+            size_t start = 0;
+            if (!state.flag)
+            {
+                start = SkipWhitespace(in, length);
+                state.flag = start < length;
+            }
+            out.append(in + start, length - start);
+        }
+
+        void TrimEndBlock(OpState& state, const char* in, size_t length, std::string& out)
+        {
+            const size_t end = TrimmedEnd(in, length);
+            if (end == 0)
+            {
+                state.held.append(in, length);
+                return;
+            }
+
+            // Text follows the held whitespace, so it was not trailing
+            out.append(state.held);
+            out.append(in, end);
+            state.held.assign(in + end, length - end);
+        }
+
+        void CollapseBlock(OpState& state, const char* in, size_t length, std::string& out)
+        {
+            AppendWith(out, length, [&state, in, length](char* write)
+            {
+                return CollapseWhitespaceCopy(in, length, write, state.flag);
+            });
+        }
+
+        void TitleBlock(OpState& state, const char* in, size_t length, std::string& out)
+        {
+            AppendWith(out, length, [&state, in, length](char* write)
+            {
+                bool inWord = state.flag;
+                for (size_t i = 0; i < length; i++)
+                {
+                    const unsigned char c = static_cast<unsigned char>(in[i]);
+                    if (IsWordSeparator(c))
+                    {
+                        *write++ = static_cast<char>(c);
+                        inWord = false;
+                    }
+                    else
+                    {
+                        *write++ = inWord ? g_case.lower[c] : g_case.upper[c];
+                        inWord = true;
+                    }
+                }
+                state.flag = inWord;
+                return write;
+            });
+        }
+
+        void StripControlBlock(const char* in, size_t length, std::string& out)
+        {
+            AppendWith(out, length, [in, length](char* write)
+            {
+                return StripControlCopy(in, length, write);
+            });
+        }
+
+        void RunBlock(TransformOp op, OpState& state, const char* in, size_t length, std::string& out)
+        {
+            switch (op)
+            {
+            case kTransform_TrimStart:      TrimStartBlock(state, in, length, out); break;
+            case kTransform_TrimEnd:        TrimEndBlock(state, in, length, out); break;
+            case kTransform_Collapse:       CollapseBlock(state, in, length, out); break;
+            case kTransform_Title:          TitleBlock(state, in, length, out); break;
+            case kTransform_StripControl:   StripControlBlock(in, length, out); break;
+            }
+        }
+    }
+
+    TextTransform::TextTransform(const std::string& spec)
+    {
+        const std::string folded = ToLowerCopy(spec);
+
+        size_t nameStart = 0;
+        while (nameStart <= folded.length())
+        {
+            size_t nameEnd = folded.find('|', nameStart);
+            if (nameEnd == std::string::npos)
+            {
+                nameEnd = folded.length();
+            }
+
+            // Spaces around a name are allowed, as in "trim | title"
+            size_t first = nameStart;
+            size_t last = nameEnd;
+            while (first < last && folded[first] == ' ')
+            {
+                first++;
+            }
+            while (last > first && folded[last - 1] == ' ')
+            {
+                last--;
+            }
+
+            const std::string name = folded.substr(first, last - first);
+            if (name == "trim")
+            {
+                m_ops.push_back(kTransform_TrimStart);
+                m_ops.push_back(kTransform_TrimEnd);
+            }
+            else if (name == "trim-start")
+            {
+                m_ops.push_back(kTransform_TrimStart);
+            }
+            else if (name == "trim-end")
+            {
+                m_ops.push_back(kTransform_TrimEnd);
+            }
+            else if (name == "collapse")
+            {
+                m_ops.push_back(kTransform_Collapse);
+            }
+            else if (name == "title")
+            {
+                m_ops.push_back(kTransform_Title);
+            }
+            else if (name == "strip-control")
+            {
+                m_ops.push_back(kTransform_StripControl);
+            }
+            else if (!name.empty())
+            {
+                m_valid = false;
+                m_ops.clear();
+                return;
+            }
+
+            nameStart = nameEnd + 1;
+        }
+    }
+
+    std::string TextTransform::Apply(const std::string& source) const
+    {
+        const char* begin = source.data();
+        const char* end = begin + source.length();
+
+        // Trims ahead of every other op only move the ends of the source
+        size_t first = 0;
+        for (; first < m_ops.size(); first++)
+        {
+            if (m_ops[first] == kTransform_TrimStart)
+            {
+                begin += SkipWhitespace(begin, end - begin);
+            }
+            else if (m_ops[first] == kTransform_TrimEnd)
+            {
+                end = begin + TrimmedEnd(begin, end - begin);
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        // No op makes the text longer
+        std::string result;
+        result.reserve(end - begin);
+
+        if (first == m_ops.size())
+        {
+            result.assign(begin, end);
+            return result;
+        }
+
+        // Each block goes through every op while it is still in cache. The
+        // last op appends to the result; the others hand over through two
+        // scratch buffers.
+        std::vector<OpState> states(m_ops.size());
+        std::string scratch[2];
+
+        for (const char* block = begin; block < end; block += TRANSFORM_BLOCK_SIZE)
+        {
+            const char* in = block;
+            size_t length = std::min<size_t>(TRANSFORM_BLOCK_SIZE, end - block);
+
+            for (size_t i = first; i < m_ops.size(); i++)
+            {
+                const bool last = i + 1 == m_ops.size();
+                std::string& out = last ? result : scratch[i & 1];
+                if (!last)
+                {
+                    out.clear();
+                }
+
+                RunBlock(m_ops[i], states[i], in, length, out);
+
+                in = out.data();
+                length = out.length();
+            }
+        }
+
+        // Whitespace still held by a trim-end op is trailing, and is dropped
+        return result;
+    }
+
+    const TextTransform& CompiledTransformFor(const BSFixedString& specBS)
+    {
+        if (!t_transformCache)
+        {
+            t_transformCache = new TransformCache();
+        }
+
+        TransformCache& cache = *t_transformCache;
+        const UInt64 now = ++cache.clock;
+
+        CachedTransform* oldest = &cache.entries[0];
+        for (CachedTransform& entry : cache.entries)
+        {
+            if (entry.transform && entry.spec.data == specBS.data)
+            {
+                entry.lastUse = now;
+                return *entry.transform;
+            }
+
+            if (entry.lastUse < oldest->lastUse)
+            {
+                oldest = &entry;
+            }
+        }
+
+        const char* spec = specBS.c_str();
+        oldest->spec = specBS;
+        oldest->transform.reset(new TextTransform(spec ? spec : ""));
+        oldest->lastUse = now;
+        return *oldest->transform;
+    }
+}
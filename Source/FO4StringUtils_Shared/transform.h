@@ -0,0 +1,65 @@
+#pragma once
+
+// ================
+// Fused Transforms
+// ================
+
+// F4SE
+#include "f4se/PapyrusNativeFunctions.h"    // for BSFixedString
+
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+namespace Papyrus
+{
+    // Compiled specs remembered per VM thread, looked up by the spec's
+    // interned pointer
+    constexpr size_t TRANSFORM_CACHE_ENTRIES = 4;
+
+    // Bytes of source taken through every op at a time, small enough to
+    // stay in the first-level cache between ops
+    constexpr size_t TRANSFORM_BLOCK_SIZE = 4096;
+
+    enum TransformOp : UInt8
+    {
+        kTransform_TrimStart,       // "trim-start", or half of "trim"
+        kTransform_TrimEnd,         // "trim-end", or half of "trim"
+        kTransform_Collapse,        // "collapse": each whitespace run becomes one space
+        kTransform_Title,           // "title": as ToTitleCase
+        kTransform_StripControl,    // "strip-control": drops bytes 0-31 and 127
+    };
+
+    // An op list such as "trim|collapse|title|strip-control", compiled once.
+    //
+    // Apply reads the source once. Trims at the front of the list just
+    // narrow the source; after that the source is taken in blocks, and each
+    // block runs through every op in turn while it is still in cache, with
+    // each op carrying its state (inside a word, inside a whitespace run,
+    // whitespace not yet known to be trailing) on to the next block. The
+    // result is the one the ops would give run one after another, without
+    // building or interning the strings in between.
+    //
+    class TextTransform
+    {
+    public:
+        // Op names are separated by "|" and matched without regard to
+        // case. An unknown name makes the whole spec invalid.
+        //
+        explicit TextTransform(const std::string& spec);
+
+        bool IsValid() const { return m_valid; }
+
+        std::string Apply(const std::string& source) const;
+
+    private:
+        std::vector<TransformOp> m_ops;
+        bool m_valid = true;
+    };
+
+    // Usage: const TextTransform& transform = CompiledTransformFor(specBS);
+    //
+    // The reference stays valid until this thread compiles
+    // TRANSFORM_CACHE_ENTRIES other specs.
+    //
+    const TextTransform& CompiledTransformFor(const BSFixedString& specBS);
+}
@@ -0,0 +1,108 @@
+// ======================
+// UTF-8 Code Point Index
+// ======================
+
+#include <algorithm>                        // for std::reverse
+#include <cstring>                          // for memcpy
+
+#include "simd.h"                           // for Simd
+#include "utf8.h"                           // for Utf8Index
+
+namespace Papyrus
+{
+    Utf8Index::Utf8Index(const char* str, size_t len)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(str);
+        m_breadcrumbs.reserve(len / UTF8_BREADCRUMB_STRIDE + 1);
+
+        // Character index whose offset is recorded next
+        size_t nextCrumb = 0;
+        size_t i = 0;
+
+        while (i < len)
+        {
+#if PAPYRUS_SSE2
+            // ASCII block: 16 characters of one byte each, offsets follow directly
+            if (i + Simd::WIDTH <= len && Simd::Mask(Simd::Load(str + i)) == 0)
+            {
+                for (; nextCrumb < m_length + Simd::WIDTH; nextCrumb += UTF8_BREADCRUMB_STRIDE)
+                {
+                    m_breadcrumbs.push_back(static_cast<UInt32>(i + (nextCrumb - m_length)));
+                }
+
+                m_length += Simd::WIDTH;
+                i += Simd::WIDTH;
+                continue;
+            }
+#endif
+            if (m_length == nextCrumb)
+            {
+                m_breadcrumbs.push_back(static_cast<UInt32>(i));
+                nextCrumb += UTF8_BREADCRUMB_STRIDE;
+            }
+
+            const size_t length = Utf8SequenceLength(bytes + i, len - i);
+            if (length != 1)
+            {
+                m_ascii = false;
+            }
+            if (length == 0)
+            {
+                m_valid = false;
+            }
+
+            i += length ? length : 1;
+            m_length++;
+        }
+    }
+
+    size_t Utf8Index::ByteOffset(const char* str, size_t len, size_t index) const
+    {
+        if (index >= m_length)
+        {
+            return len;
+        }
+
+        // One byte per character: the index is the offset
+        if (m_ascii)
+        {
+            return index;
+        }
+
+        // Jump to the nearest breadcrumb at or before index, then walk forward
+        size_t offset = m_breadcrumbs[index / UTF8_BREADCRUMB_STRIDE];
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(str);
+
+        for (size_t remaining = index % UTF8_BREADCRUMB_STRIDE; remaining > 0; remaining--)
+        {
+            offset += Utf8CharLength(bytes + offset, len - offset);
+        }
+
+        return offset;
+    }
+
+    std::string Utf8ReverseCopy(const char* str, size_t len, const Utf8Index& index)
+    {
+        std::string result(str, len);
+
+        // Single-byte characters reverse as plain bytes
+        if (index.IsASCII())
+        {
+            std::reverse(result.begin(), result.end());
+            return result;
+        }
+
+        // Copy each character, front to back, into its mirrored position
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(str);
+        size_t i = 0;
+
+        while (i < len)
+        {
+            const size_t length = Utf8CharLength(bytes + i, len - i);
+            memcpy(&result[len - i - length], str + i, length);
+            i += length;
+        }
+
+        return result;
+    }
+}
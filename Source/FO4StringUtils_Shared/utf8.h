@@ -0,0 +1,112 @@
+#pragma once
+
+// ======================
+// UTF-8 Code Point Index
+// ======================
+
+#include <string>                           // for std::string
+#include <vector>                           // for std::vector
+
+namespace Papyrus
+{
+    // One byte offset is kept per this many code points, so finding any code
+    // point walks at most BREADCRUMB_STRIDE - 1 sequences
+    constexpr size_t UTF8_BREADCRUMB_STRIDE = 32;
+
+    // Length of the well-formed UTF-8 sequence at p (RFC 3629: no overlongs,
+    // surrogates or values past U+10FFFF), or 0 if p does not start one.
+    //
+    inline size_t Utf8SequenceLength(const unsigned char* p, size_t remaining)
+    {
+        const unsigned char lead = p[0];
+
+        if (lead < 0x80)
+        {
+            return 1;
+        }
+
+        // Bounds of the first continuation byte depend on the lead byte
+        unsigned char low = 0x80;
+        unsigned char high = 0xBF;
+        size_t length = 0;
+
+        if (lead < 0xC2)
+        {
+            return 0;
+        }
+        else if (lead < 0xE0)
+        {
+            length = 2;
+        }
+        else if (lead < 0xF0)
+        {
+            length = 3;
+            if (lead == 0xE0) low = 0xA0;
+            if (lead == 0xED) high = 0x9F;
+        }
+        else if (lead < 0xF5)
+        {
+            length = 4;
+            if (lead == 0xF0) low = 0x90;
+            if (lead == 0xF4) high = 0x8F;
+        }
+        else
+        {
+            return 0;
+        }
+
+        if (remaining < length || p[1] < low || p[1] > high)
+        {
+            return 0;
+        }
+
+        for (size_t i = 2; i < length; i++)
+        {
+            if ((p[i] & 0xC0) != 0x80)
+            {
+                return 0;
+            }
+        }
+
+        return length;
+    }
+
+    // Bytes taken by the character at p. A byte that does not start a valid
+    // sequence counts as a character of its own, so malformed text is never
+    // rejected and always round-trips unchanged.
+    //
+    inline size_t Utf8CharLength(const unsigned char* p, size_t remaining)
+    {
+        const size_t length = Utf8SequenceLength(p, remaining);
+        return length ? length : 1;
+    }
+
+    // Code point count and sparse byte offsets for one string
+    //
+    class Utf8Index
+    {
+    public:
+        Utf8Index(const char* str, size_t len);
+
+        // Number of characters (code points plus stray bytes)
+        size_t Length() const { return m_length; }
+
+        bool IsASCII() const { return m_ascii; }
+        bool IsValid() const { return m_valid; }
+
+        // Byte offset where character index starts; index == Length() gives
+        // the byte length. str must be the string the index was built from.
+        //
+        size_t ByteOffset(const char* str, size_t len, size_t index) const;
+
+    private:
+        std::vector<UInt32> m_breadcrumbs;  // byte offset of every UTF8_BREADCRUMB_STRIDE'th character
+        size_t m_length = 0;
+        bool m_ascii = true;
+        bool m_valid = true;
+    };
+
+    // Reverse the order of characters, keeping each sequence's bytes in order
+    //
+    std::string Utf8ReverseCopy(const char* str, size_t len, const Utf8Index& index);
+}
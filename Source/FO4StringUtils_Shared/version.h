@@ -5,3 +5,7 @@
 const char* PluginVersion();
 const char* GameVersion();
 const char* RuntimeVersion();
+
+// Plugin log file path relative to the My Documents folder
+//
+const char* LogFilePath();